@@ -19,7 +19,7 @@ int main(void) {
     GPIO_DrivePortBPin(PIN0, HIGH);
     GPIO_DrivePortBPin(PIN1, HIGH);
 
-    WAV_Sine_Init(1000, 100000);                                                   // 1kHz @ 100kHz sampling frequency
+    WAV_Sine_Init(false, false, 1000, 100000);                                  // 1kHz @ 100kHz sampling frequency
     
     // RUN
     WAV_Sine_Start();
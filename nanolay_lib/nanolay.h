@@ -74,7 +74,8 @@ void Sys_Init(Clock_Freq clk);
 #include "nanolay_gpio.h"
 #include "nanolay_tmr1.h"
 #include "nanolay_sccp.h"
-//#include "nanolay_adc.h"
+#include "nanolay_dma.h"
+#include "nanolay_adc.h"
 #include "nanolay_dac.h"
 //#include "nanolay_pwmx.h"
 
@@ -0,0 +1,559 @@
+/* ************************************************************************** */
+// Nanolay - ADC Library Source File
+//
+// Description:     Custom dsPIC33CK library for ADC functions. Should be
+//                  included in the nanolay.h file
+//
+// Target Device:   dsPIC33CKxxxMP202
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include "nanolay_adc.h"
+
+ADC_Stat adcStat;
+ADC_Stream adcStream;
+ADC_Oversample adcOversample;
+void (*ADC_Stream_BlockHandler)(const uint16_t * const *blocks, uint_fast16_t count) = NULL;
+void (*ADC_Oversample_ResultHandler)(const uint16_t *results, uint_fast16_t count) = NULL;
+ADC_Threshold adcThreshold[ADC_THRESHOLDS];
+void (*ADC_Threshold0_Handler)(uint_fast8_t n, bool active, uint16_t value) = NULL;
+void (*ADC_Threshold1_Handler)(uint_fast8_t n, bool active, uint16_t value) = NULL;
+void (*ADC_Threshold2_Handler)(uint_fast8_t n, bool active, uint16_t value) = NULL;
+void (*ADC_Threshold3_Handler)(uint_fast8_t n, bool active, uint16_t value) = NULL;
+
+
+// ADCMPxCON compare mode bits, an event is raised if any selected test passes
+#define ADC_CMP_BTWN    0x0010                                                  // LO <= value < HI
+#define ADC_CMP_HIHI    0x0008                                                  // value >= HI
+#define ADC_CMP_HILO    0x0004                                                  // value < HI
+#define ADC_CMP_LOHI    0x0002                                                  // value >= LO
+#define ADC_CMP_LOLO    0x0001                                                  // value < LO
+#define ADC_CMP_MODE_MASK   0x001F
+
+
+static inline void ADC_SetTrigger(uint_fast8_t input, uint_fast8_t source){
+    ((volatile uint8_t *) &ADTRIG0L)[input] = source;                           // one TRGSRC byte per input, ADTRIG0L holds AN0 and AN1
+}
+
+
+static inline uint_fast8_t ADC_GetTrigger(uint_fast8_t input){
+    return ((volatile uint8_t *) &ADTRIG0L)[input];
+}
+
+
+static inline volatile uint16_t *ADC_Buffer(uint_fast8_t input){
+    return &ADCBUF0 + input;
+}
+
+
+void ADC_Init(bool activeOnIdle){
+    uint_fast8_t i;
+
+    PMD1bits.ADC1MD = 0;                                                        // enable ADC module
+
+    ADCON1L = 0x0000;                                                           // ADON disabled; NRE disabled;
+    ADCON1Lbits.ADSIDL = !activeOnIdle;
+    ADCON1H = 0x0060;                                                           // FORM Integer; SHRRES 12-bit resolution;
+    ADCON2L = 0x0000;                                                           // SHRADCS 2; REFCIE disabled; SHREISEL Early interrupt 1 TADCORE;
+    ADCON2H = 0x0000;
+    ADCON2Hbits.SHRSAMC = ADC_SAMPLE_TIME - 2;                                  // shared core sampling time in TAD
+    ADCON3L = 0x0000;                                                           // REFSEL AVdd-AVss; SUSPEND disabled; CNVRTCH disabled;
+    ADCON3H = 0x0000;                                                           // CLKSEL FOSC/2; CLKDIV 1; dedicated and shared cores off
+    ADCON4L = 0x0003;                                                           // SAMC0EN, SAMC1EN: dedicated cores sample after the trigger
+    ADCON4H = 0x0000;                                                           // C0CHS AN0; C1CHS AN1;
+    ADMOD0L = 0x0000;                                                           // all inputs single ended, unsigned
+    ADMOD0H = 0x0000;
+    ADMOD1L = 0x0000;
+    ADIEL = 0x0000;                                                             // no per input interrupts
+    ADIEH = 0x0000;
+    ADCORE0L = ADC_SAMPLE_TIME - 2;                                             // SAMC in TAD
+    ADCORE0H = 0x0300;                                                          // EISEL 1 TAD; RES 12-bit; ADCS 2;
+    ADCORE1L = ADC_SAMPLE_TIME - 2;
+    ADCORE1H = 0x0300;
+    ADCON5L = 0x0000;
+    ADCON5H = 0x0000;
+    ADCON5Hbits.WARMTIME = 0xF;                                                 // longest power up delay, 32768 source clocks
+    for (i = 0; i <= ADC_MAX_INPUT; i++){
+        ADC_SetTrigger(i, 0);
+    }
+
+    ADCON1Lbits.ADON = 1;
+
+    ADCON5Lbits.C0PWR = 1;                                                      // power up dedicated core 0
+    while (ADCON5Lbits.C0RDY == 0);
+    ADCON3Hbits.C0EN = 1;
+    ADCON5Lbits.C1PWR = 1;                                                      // power up dedicated core 1
+    while (ADCON5Lbits.C1RDY == 0);
+    ADCON3Hbits.C1EN = 1;
+    ADCON5Lbits.SHRPWR = 1;                                                     // power up shared core
+    while (ADCON5Lbits.SHRRDY == 0);
+    ADCON3Hbits.SHREN = 1;
+
+    adcStat.adcEn = true;
+}
+
+
+uint16_t ADC_Read(uint_fast8_t input){
+    uint16_t mask = 1 << (input & 0x0F);
+
+    ADCON3Lbits.CNVCHSEL = input;
+    ADCON3Lbits.CNVRTCH = 1;                                                    // software trigger of one input, cleared by hardware
+    if (input < 16){
+        while ((ADSTATL & mask) == 0);
+    }
+    else {
+        while ((ADSTATH & mask) == 0);
+    }
+    return *ADC_Buffer(input);                                                  // reading the buffer clears the ready bit
+}
+
+
+static void ADC_Stream_DMAHandler(bool half){
+    uint_fast16_t offset = half ? 0 : adcStream.halfLength;                     // half = first half is full
+    uint_fast8_t i;
+
+    for (i = 0; i < adcStream.count; i++){
+        adcStream.block[i] = adcStream.buffer[i] + offset;
+    }
+    ADC_Stream_BlockHandler(adcStream.block, adcStream.halfLength);
+}
+
+
+static uint_fast32_t ADC_TriggerInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq){
+    uint32_t clock = SCCP_GetClkFreq();
+    uint_fast32_t period;
+
+    if (samplingFreq == 0){
+        samplingFreq = 1;
+    }
+    period = SCCP7_TriggerInit(activeOnIdle, activeOnSleep, (clock + (samplingFreq / 2)) / samplingFreq);
+    adcStream.samplingFrequency = (clock + (period / 2)) / period;
+    return adcStream.samplingFrequency;
+}
+
+
+uint_fast32_t ADC_StreamInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, const uint8_t *inputs, uint_fast8_t count, uint16_t * const *buffers, uint_fast16_t length, void (* BlockHandler)(const uint16_t * const *blocks, uint_fast16_t count), uint_fast8_t priority){
+    uint_fast8_t i;
+
+    if (count == 0){                                                            // no channel to serve, DMA_CH1 + count - 1 would be the DAC channel
+        return 0;
+    }
+    if (!adcStat.adcEn){
+        ADC_Init(activeOnIdle);
+    }
+    if (count > ADC_MAX_CHANNELS){
+        count = ADC_MAX_CHANNELS;
+    }
+    ADC_TriggerInit(activeOnIdle, activeOnSleep, samplingFreq);
+
+    adcStream.count = count;
+    adcStream.dmaEn = true;
+    adcStream.halfLength = length / 2;
+    ADC_Stream_BlockHandler = BlockHandler;
+
+    for (i = 0; i < count; i++){
+        adcStream.input[i] = inputs[i];
+        adcStream.buffer[i] = buffers[i];
+        ADC_SetTrigger(inputs[i], ADC_TRGSRC_SCCP7);
+        DMA_ChannelInit((DMA_Channel) (DMA_CH1 + i), DMA_TRIG_SCCP7_CCP, ADC_Buffer(inputs[i]), DMA_ADDR_FIXED, buffers[i], DMA_ADDR_INC, length, DMA_REPEATED_ONESHOT);
+    }
+    if (BlockHandler != NULL){                                                  // the last channel is served last, its half means all halves are full
+        DMA_SetInterrupt((DMA_Channel) (DMA_CH1 + count - 1), true, ADC_Stream_DMAHandler, priority);
+    }
+    return adcStream.samplingFrequency;
+}
+
+
+void ADC_StreamStart(void){
+    uint_fast8_t i;
+
+    for (i = 0; i < adcStream.count; i++){
+        ADC_SetTrigger(adcStream.input[i], ADC_TRGSRC_SCCP7);                   // ADC_StreamStop() left them untriggered
+        if (adcStream.dmaEn){
+            ADC_Read(adcStream.input[i]);                                       // fresh ADCBUFx for the first DMA move, not a stale result
+            DMA_Start((DMA_Channel) (DMA_CH1 + i));
+        }
+    }
+    CCP7CON1Lbits.CCPON = true;
+}
+
+
+void ADC_StreamStop(void){
+    uint_fast8_t i;
+
+    CCP7CON1Lbits.CCPON = false;
+    for (i = 0; i < adcStream.count; i++){
+        if (adcStream.dmaEn){
+            DMA_Stop((DMA_Channel) (DMA_CH1 + i));
+        }
+        ADC_SetTrigger(adcStream.input[i], 0);
+    }
+}
+
+
+uint_fast32_t ADC_GetSamplingFrequency(void){
+    return adcStream.samplingFrequency;
+}
+
+
+uint_fast32_t ADC_MonitorInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, const uint8_t *inputs, uint_fast8_t count){
+    uint_fast8_t i;
+
+    if (count == 0){                                                            // no channel to serve, DMA_CH1 + count - 1 would be the DAC channel
+        return 0;
+    }
+    if (!adcStat.adcEn){
+        ADC_Init(activeOnIdle);
+    }
+    if (count > ADC_MAX_CHANNELS){
+        count = ADC_MAX_CHANNELS;
+    }
+    adcStream.count = count;
+    adcStream.dmaEn = false;
+    for (i = 0; i < count; i++){
+        adcStream.input[i] = inputs[i];
+        ADC_SetTrigger(inputs[i], ADC_TRGSRC_SCCP7);
+    }
+    return ADC_TriggerInit(activeOnIdle, activeOnSleep, samplingFreq);
+}
+
+
+static void ADC_Threshold_Write(uint_fast8_t n, uint16_t modeBits, uint16_t lo, uint16_t hi){
+    switch ( n ){
+        case 0:
+            ADCMP0CONbits.CMPEN = 0;                                            // no compare while limits change
+            ADCMP0LO = lo;
+            ADCMP0HI = hi;
+            ADCMP0CON = (ADCMP0CON & ~ADC_CMP_MODE_MASK) | modeBits;
+            ADCMP0CONbits.CMPEN = 1;
+            break;
+        case 1:
+            ADCMP1CONbits.CMPEN = 0;                                            // no compare while limits change
+            ADCMP1LO = lo;
+            ADCMP1HI = hi;
+            ADCMP1CON = (ADCMP1CON & ~ADC_CMP_MODE_MASK) | modeBits;
+            ADCMP1CONbits.CMPEN = 1;
+            break;
+        case 2:
+            ADCMP2CONbits.CMPEN = 0;                                            // no compare while limits change
+            ADCMP2LO = lo;
+            ADCMP2HI = hi;
+            ADCMP2CON = (ADCMP2CON & ~ADC_CMP_MODE_MASK) | modeBits;
+            ADCMP2CONbits.CMPEN = 1;
+            break;
+        case 3:
+            ADCMP3CONbits.CMPEN = 0;                                            // no compare while limits change
+            ADCMP3LO = lo;
+            ADCMP3HI = hi;
+            ADCMP3CON = (ADCMP3CON & ~ADC_CMP_MODE_MASK) | modeBits;
+            ADCMP3CONbits.CMPEN = 1;
+            break;
+    }
+}
+
+
+static void ADC_Threshold_Arm(uint_fast8_t n){
+    ADC_Threshold *t = &adcThreshold[n];
+    uint16_t lo = t->low;
+    uint16_t hi = t->high;
+
+    if (!t->active){                                                            // wait for the limit to be crossed
+        switch ( t->mode ){
+            case ADC_THRESHOLD_ABOVE:
+                ADC_Threshold_Write(n, ADC_CMP_HIHI, lo, hi);
+                break;
+            case ADC_THRESHOLD_BELOW:
+                ADC_Threshold_Write(n, ADC_CMP_LOLO, lo, hi);
+                break;
+            case ADC_THRESHOLD_INSIDE:
+                ADC_Threshold_Write(n, ADC_CMP_BTWN, lo, hi);
+                break;
+            default:
+                ADC_Threshold_Write(n, ADC_CMP_HIHI | ADC_CMP_LOLO, lo, hi);
+                break;
+        }
+        return;
+    }
+
+    switch ( t->mode ){                                                         // wait for the release, hyst back across the limit
+        case ADC_THRESHOLD_ABOVE:
+            hi = (hi > t->hyst) ? (hi - t->hyst) : 0;
+            ADC_Threshold_Write(n, ADC_CMP_HILO, lo, hi);
+            break;
+        case ADC_THRESHOLD_BELOW:
+            lo = ((lo + t->hyst) < ADC_FULL_SCALE) ? (lo + t->hyst) : (ADC_FULL_SCALE - 1);
+            ADC_Threshold_Write(n, ADC_CMP_LOHI, lo, hi);
+            break;
+        case ADC_THRESHOLD_INSIDE:
+            lo = (lo > t->hyst) ? (lo - t->hyst) : 0;
+            hi = ((hi + t->hyst) < ADC_FULL_SCALE) ? (hi + t->hyst) : ADC_FULL_SCALE;
+            ADC_Threshold_Write(n, ADC_CMP_HIHI | ADC_CMP_LOLO, lo, hi);
+            break;
+        default:
+            lo = lo + t->hyst;
+            hi = (hi > t->hyst) ? (hi - t->hyst) : 0;
+            ADC_Threshold_Write(n, ADC_CMP_BTWN, lo, hi);
+            break;
+    }
+}
+
+
+void ADC_ThresholdInit(uint_fast8_t n, uint_fast8_t input, ADC_ThresholdMode mode, uint16_t low, uint16_t high, uint16_t hyst, void (* ThresholdHandler)(uint_fast8_t n, bool active, uint16_t value), uint_fast8_t priority){
+    if (n >= ADC_THRESHOLDS){
+        return;
+    }
+    if (!adcStat.adcEn){
+        ADC_Init(false);
+    }
+    adcThreshold[n].input = input;
+    adcThreshold[n].mode = mode;
+    adcThreshold[n].low = low;
+    adcThreshold[n].high = high;
+    adcThreshold[n].hyst = hyst;
+    adcThreshold[n].active = false;
+
+    switch ( n ){
+        case 0:
+            IEC6bits.ADCMP0IE = false;
+            ADCMP0CON = 0x0000;
+            ADCMP0ENL = (input < 16) ? (1 << input) : 0;
+            ADCMP0ENH = (input < 16) ? 0 : (1 << (input - 16));
+            ADCMP0CONbits.IE = 1;
+            ADC_Threshold0_Handler = ThresholdHandler;
+            IPC25bits.ADCMP0IP = priority;
+            IFS6bits.ADCMP0IF = false;
+            IEC6bits.ADCMP0IE = true;
+            break;
+        case 1:
+            IEC6bits.ADCMP1IE = false;
+            ADCMP1CON = 0x0000;
+            ADCMP1ENL = (input < 16) ? (1 << input) : 0;
+            ADCMP1ENH = (input < 16) ? 0 : (1 << (input - 16));
+            ADCMP1CONbits.IE = 1;
+            ADC_Threshold1_Handler = ThresholdHandler;
+            IPC25bits.ADCMP1IP = priority;
+            IFS6bits.ADCMP1IF = false;
+            IEC6bits.ADCMP1IE = true;
+            break;
+        case 2:
+            IEC6bits.ADCMP2IE = false;
+            ADCMP2CON = 0x0000;
+            ADCMP2ENL = (input < 16) ? (1 << input) : 0;
+            ADCMP2ENH = (input < 16) ? 0 : (1 << (input - 16));
+            ADCMP2CONbits.IE = 1;
+            ADC_Threshold2_Handler = ThresholdHandler;
+            IPC26bits.ADCMP2IP = priority;
+            IFS6bits.ADCMP2IF = false;
+            IEC6bits.ADCMP2IE = true;
+            break;
+        case 3:
+            IEC6bits.ADCMP3IE = false;
+            ADCMP3CON = 0x0000;
+            ADCMP3ENL = (input < 16) ? (1 << input) : 0;
+            ADCMP3ENH = (input < 16) ? 0 : (1 << (input - 16));
+            ADCMP3CONbits.IE = 1;
+            ADC_Threshold3_Handler = ThresholdHandler;
+            IPC26bits.ADCMP3IP = priority;
+            IFS6bits.ADCMP3IF = false;
+            IEC6bits.ADCMP3IE = true;
+            break;
+    }
+    ADC_Threshold_Arm(n);
+}
+
+
+bool ADC_ThresholdIsActive(uint_fast8_t n){
+    return (n < ADC_THRESHOLDS) && adcThreshold[n].active;
+}
+
+
+void ADC_ThresholdDisable(uint_fast8_t n){
+    switch ( n ){
+        case 0:
+            IEC6bits.ADCMP0IE = false;
+            ADCMP0CON = 0x0000;
+            break;
+        case 1:
+            IEC6bits.ADCMP1IE = false;
+            ADCMP1CON = 0x0000;
+            break;
+        case 2:
+            IEC6bits.ADCMP2IE = false;
+            ADCMP2CON = 0x0000;
+            break;
+        case 3:
+            IEC6bits.ADCMP3IE = false;
+            ADCMP3CON = 0x0000;
+            break;
+    }
+}
+
+
+static inline void ADC_Threshold_Event(uint_fast8_t n, uint16_t value, void (* ThresholdHandler)(uint_fast8_t n, bool active, uint16_t value)){
+    adcThreshold[n].active = !adcThreshold[n].active;
+    ADC_Threshold_Arm(n);                                                       // only the opposite crossing interrupts next
+    if (ThresholdHandler != NULL){
+        ThresholdHandler(n, adcThreshold[n].active, value);
+    }
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _ADCMP0Interrupt (void){
+    uint16_t value = *ADC_Buffer(adcThreshold[0].input);
+
+    IFS6bits.ADCMP0IF = false;
+    ADC_Threshold_Event(0, value, ADC_Threshold0_Handler);
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _ADCMP1Interrupt (void){
+    uint16_t value = *ADC_Buffer(adcThreshold[1].input);
+
+    IFS6bits.ADCMP1IF = false;
+    ADC_Threshold_Event(1, value, ADC_Threshold1_Handler);
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _ADCMP2Interrupt (void){
+    uint16_t value = *ADC_Buffer(adcThreshold[2].input);
+
+    IFS6bits.ADCMP2IF = false;
+    ADC_Threshold_Event(2, value, ADC_Threshold2_Handler);
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _ADCMP3Interrupt (void){
+    uint16_t value = *ADC_Buffer(adcThreshold[3].input);
+
+    IFS6bits.ADCMP3IF = false;
+    ADC_Threshold_Event(3, value, ADC_Threshold3_Handler);
+}
+
+
+static bool ADC_IsSimultaneous(const uint8_t *inputs, uint_fast8_t count){
+    uint_fast8_t i, j, shared = 0;
+
+    if ((count == 0) || (count > ADC_MAX_CHANNELS)){
+        return false;
+    }
+    for (i = 0; i < count; i++){
+        for (j = 0; j < i; j++){
+            if (inputs[j] == inputs[i]){
+                return false;                                                   // one core cannot convert the same input twice
+            }
+        }
+        if (inputs[i] >= ADC_DEDICATED_INPUTS){
+            shared++;
+        }
+    }
+    return (shared <= 1);                                                       // a second shared input would convert after the first
+}
+
+
+uint_fast32_t ADC_SimultaneousInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, const uint8_t *inputs, uint_fast8_t count, uint16_t * const *buffers, uint_fast16_t length, void (* BlockHandler)(const uint16_t * const *blocks, uint_fast16_t count), uint_fast8_t priority){
+    if (!ADC_IsSimultaneous(inputs, count)){
+        return 0;
+    }
+    return ADC_StreamInit(activeOnIdle, activeOnSleep, samplingFreq, inputs, count, buffers, length, BlockHandler, priority);
+}
+
+
+bool ADC_SimultaneousRead(const uint8_t *inputs, uint_fast8_t count, uint16_t *tuple){
+    uint_fast8_t trigger[ADC_MAX_CHANNELS];
+    uint_fast8_t i;
+
+    if (!ADC_IsSimultaneous(inputs, count)){
+        return false;
+    }
+    if (!adcStat.adcEn){
+        ADC_Init(false);
+    }
+    for (i = 0; i < count; i++){
+        trigger[i] = ADC_GetTrigger(inputs[i]);
+        ADC_SetTrigger(inputs[i], ADC_TRGSRC_SOFTWARE);
+        (void) *ADC_Buffer(inputs[i]);                                          // clears a ready bit left by an earlier conversion
+    }
+    ADCON3Lbits.SWCTRG = 1;                                                     // one trigger for all, cleared by hardware
+    for (i = 0; i < count; i++){
+        if (inputs[i] < 16){
+            while ((ADSTATL & (1 << inputs[i])) == 0);
+        }
+        else {
+            while ((ADSTATH & (1 << (inputs[i] - 16))) == 0);
+        }
+        tuple[i] = *ADC_Buffer(inputs[i]);
+        ADC_SetTrigger(inputs[i], trigger[i]);                                  // back to the caller's trigger source
+    }
+    return true;
+}
+
+
+void ADC_DecimatorInit(ADC_Decimator *d, uint_fast8_t extraBits){
+    if (extraBits < 1){
+        extraBits = 1;
+    }
+    else if (extraBits > ADC_MAX_EXTRA_BITS){
+        extraBits = ADC_MAX_EXTRA_BITS;
+    }
+    d->extraBits = extraBits;
+    d->ratio = 1 << (2 * extraBits);
+    d->pending = 0;
+    d->acc = 0;
+}
+
+
+uint_fast16_t ADC_Decimate(ADC_Decimator *d, const uint16_t *in, uint_fast16_t count, uint16_t *out){
+    uint32_t acc = d->acc;
+    uint_fast16_t pending = d->pending;
+    uint_fast16_t n, written = 0;
+
+    while (count != 0){
+        n = d->ratio - pending;                                                 // samples left for this result
+        if (n > count){
+            n = count;
+        }
+        count -= n;
+        pending += n;
+        while (n--){                                                            // tight sum, no test per sample
+            acc += *in++;
+        }
+        if (pending == d->ratio){
+            out[written++] = (uint16_t) (acc >> d->extraBits);
+            acc = 0;
+            pending = 0;
+        }
+    }
+    d->acc = acc;
+    d->pending = pending;
+    return written;
+}
+
+
+static void ADC_Oversample_BlockHandler(const uint16_t * const *blocks, uint_fast16_t count){
+    uint_fast16_t n = ADC_Decimate(&adcOversample.decimator, blocks[0], count, adcOversample.results);
+
+    if ((n != 0) && (ADC_Oversample_ResultHandler != NULL)){
+        ADC_Oversample_ResultHandler(adcOversample.results, n);
+    }
+}
+
+
+uint_fast32_t ADC_OversampleInit(bool activeOnIdle, bool activeOnSleep, uint_fast8_t input, uint_fast8_t extraBits, uint16_t *buffer, uint_fast16_t length, uint16_t *results, void (* ResultHandler)(const uint16_t *results, uint_fast16_t count), uint_fast8_t priority){
+    uint8_t inputs[1];
+    uint16_t *buffers[1];
+    uint_fast32_t samplingFreq;
+
+    inputs[0] = input;
+    buffers[0] = buffer;
+    ADC_DecimatorInit(&adcOversample.decimator, extraBits);
+    adcOversample.results = results;
+    ADC_Oversample_ResultHandler = ResultHandler;
+
+    samplingFreq = ADC_StreamInit(activeOnIdle, activeOnSleep, SCCP_GetClkFreq() / ADC_OVERSAMPLE_PERIOD, inputs, 1, buffers, length, ADC_Oversample_BlockHandler, priority);
+    adcOversample.outputFrequency = samplingFreq >> (2 * adcOversample.decimator.extraBits);
+    return adcOversample.outputFrequency;
+}
@@ -0,0 +1,297 @@
+/* ************************************************************************** */
+// Nanolay - ADC Library Header File
+//
+// Description:     Custom dsPIC33CK library for ADC functions. Should be
+//                  included in the nanolay.h file
+//
+// Target Device:   dsPIC33CKxxxMP202
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+
+#ifndef _NANOLAY_ADC_H
+#define	_NANOLAY_ADC_H
+
+
+#include "nanolay.h"
+
+
+#define ADC_MAX_INPUT       19                                                  // AN0 to AN19
+#define ADC_MAX_CHANNELS    3                                                   // one DMA channel each, DMA_CH0 belongs to the DAC stream
+#define ADC_FULL_SCALE      4096
+#define ADC_SAMPLE_TIME     8                                                   // sampling time in TAD, minimum 2
+#define ADC_OVERSAMPLE_PERIOD   64                                              // Fcy ticks per sample in oversampling mode, a dedicated core needs ~42
+#define ADC_MAX_EXTRA_BITS  4                                                   // 16bit results from 256 samples
+#define ADC_DEDICATED_INPUTS    2                                               // AN0 on core 0, AN1 on core 1, the rest share one core
+#define ADC_THRESHOLDS      4                                                   // digital comparators ADCMP0 to ADCMP3
+#define ADC_TRGSRC_SOFTWARE 0b00001                                             // ADTRIGx TRGSRC code of the common software trigger
+#define ADC_TRGSRC_SCCP7    0b11010                                             // ADTRIGx TRGSRC code of the SCCP7 compare event
+
+
+typedef struct adc_stat {
+    bool    adcEn;
+} ADC_Stat;
+
+
+typedef struct adc_stream {
+    uint_fast8_t        count;                                                  // number of channels
+    uint8_t             input[ADC_MAX_CHANNELS];                                // ANx of each channel
+    uint16_t            *buffer[ADC_MAX_CHANNELS];
+    const uint16_t      *block[ADC_MAX_CHANNELS];                               // halves passed to the handler
+    uint_fast16_t       halfLength;
+    uint_fast32_t       samplingFrequency;                                      // actual sampling frequency in Hz
+    bool                dmaEn;                                                  // false = inputs only converted, see ADC_MonitorInit()
+} ADC_Stream;
+
+
+typedef enum adc_threshold_mode {
+    ADC_THRESHOLD_ABOVE = 0,                                                    // active at or above high
+    ADC_THRESHOLD_BELOW = 1,                                                    // active below low
+    ADC_THRESHOLD_INSIDE = 2,                                                   // active from low up to high
+    ADC_THRESHOLD_OUTSIDE = 3                                                   // active below low or at or above high
+} ADC_ThresholdMode;
+
+
+typedef struct adc_threshold {
+    uint8_t             input;
+    ADC_ThresholdMode   mode;
+    uint16_t            low;
+    uint16_t            high;
+    uint16_t            hyst;                                                   // distance back across a limit before the event is released
+    volatile bool       active;
+} ADC_Threshold;
+
+
+typedef struct adc_decimator {
+    uint_fast8_t        extraBits;                                              // bits gained, ratio = 4^extraBits
+    uint_fast16_t       ratio;                                                  // samples per result
+    uint_fast16_t       pending;                                                // samples summed so far
+    uint32_t            acc;                                                    // running sum, carried across blocks
+} ADC_Decimator;
+
+
+typedef struct adc_oversample {
+    ADC_Decimator       decimator;
+    uint16_t            *results;
+    uint_fast32_t       outputFrequency;                                        // results per second
+} ADC_Oversample;
+
+
+// *****************************************************************************
+// @desc:       Initialize the ADC module: 12bit unsigned results, AVDD/AVSS
+//                  reference, all inputs single ended and untriggered. Powers
+//                  up the two dedicated cores (AN0, AN1) and the shared core.
+//                  Input pins must be left analog (ANSELx) by the caller
+// @args:       activeOnIdle [bool]: true = continues operation in Idle mode
+// @returns:    None
+// *****************************************************************************
+void ADC_Init(bool activeOnIdle);
+
+
+// *****************************************************************************
+// @desc:       Converts one input by software trigger and waits for the result.
+//                  Must not be used on an input that is part of a stream
+// @args:       input [uint_fast8_t]: ANx, 0 to ADC_MAX_INPUT
+// @returns:    [uint16_t]: 12bit result
+// *****************************************************************************
+uint16_t ADC_Read(uint_fast8_t input);
+
+
+// *****************************************************************************
+// @desc:       Initialize continuous sampling of up to ADC_MAX_CHANNELS inputs.
+//                  SCCP7 triggers all inputs at once and one DMA channel per
+//                  input (DMA_CH1 up) copies its ADCBUFx into the buffer of
+//                  that input, so there is no per sample interrupt. Each
+//                  buffer is used as a ping-pong pair of halves. DMA and
+//                  conversion share the SCCP7 trigger, so each trigger moves
+//                  the result of the one before and the stream lags one
+//                  period. ADC_StreamStart() converts each input once before
+//                  the timer runs, so the first sample is fresh and not left
+//                  over from an earlier conversion. Inputs on the shared core
+//                  convert one after another, the period has to fit all of
+//                  them
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz, rounded
+//                  to a whole number of (prescaled) Fcy ticks
+//              inputs [const uint8_t *]: ANx of each channel
+//              count [uint_fast8_t]: number of channels, 1 to ADC_MAX_CHANNELS
+//              buffers [uint16_t * const *]: one buffer per channel in data
+//                  RAM, must stay valid while streaming
+//              length [uint_fast16_t]: samples per buffer, even
+//              BlockHandler [func pointer]: called from the DMA interrupt each
+//                  time a half is full, with one block pointer per channel and
+//                  the number of samples per block. It has to finish before
+//                  the other half is full
+//              priority [uint_fast8_t]: DMA interrupt priority
+// @returns:    [uint_fast32_t]: actual sampling frequency in Hz, 0 = count is 0
+//                  and nothing was set up
+// *****************************************************************************
+uint_fast32_t ADC_StreamInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, const uint8_t *inputs, uint_fast8_t count, uint16_t * const *buffers, uint_fast16_t length, void (* BlockHandler)(const uint16_t * const *blocks, uint_fast16_t count), uint_fast8_t priority);
+
+
+// *****************************************************************************
+// @desc:       Starts the ADC stream. With DMA, each input is first converted
+//                  once by software, a few microseconds per input, so the
+//                  first sample is taken at the start
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void ADC_StreamStart(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the ADC stream. The inputs are left untriggered until the
+//                  next ADC_StreamStart()
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void ADC_StreamStop(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the sampling frequency set by ADC_StreamInit()
+// @args:       None
+// @returns:    [uint_fast32_t]: sampling frequency in Hz
+// *****************************************************************************
+uint_fast32_t ADC_GetSamplingFrequency(void);
+
+
+
+// *****************************************************************************
+// @desc:       Initialize simultaneous sampling: AN0 and AN1 on the dedicated
+//                  cores plus at most one input on the shared core. All cores
+//                  use the same sampling time and start it on the same SCCP7
+//                  event, so the sampling windows close together and index i
+//                  of every block belongs to the same instant. Otherwise the
+//                  same as ADC_StreamInit()
+// @args:       see ADC_StreamInit(), inputs must hold AN0 and/or AN1 and at
+//                  most one other input
+// @returns:    [uint_fast32_t]: actual sampling frequency in Hz, 0 if more than
+//                  one input is on the shared core or an input is listed
+//                  twice, nothing is set up then
+// *****************************************************************************
+uint_fast32_t ADC_SimultaneousInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, const uint8_t *inputs, uint_fast8_t count, uint16_t * const *buffers, uint_fast16_t length, void (* BlockHandler)(const uint16_t * const *blocks, uint_fast16_t count), uint_fast8_t priority);
+
+
+// *****************************************************************************
+// @desc:       Samples the inputs together once with the common software
+//                  trigger and waits for all results. The trigger source of
+//                  each input is restored afterwards. Same input rules as
+//                  ADC_SimultaneousInit(), must not be used while streaming
+// @args:       inputs [const uint8_t *]: ANx of each value
+//              count [uint_fast8_t]: number of inputs, 1 to ADC_MAX_CHANNELS
+//              tuple [uint16_t *]: 12bit results in the order of inputs
+// @returns:    [bool]: false = more than one input is on the shared core or an
+//                  input is listed twice
+// *****************************************************************************
+bool ADC_SimultaneousRead(const uint8_t *inputs, uint_fast8_t count, uint16_t *tuple);
+
+
+// *****************************************************************************
+// @desc:       Converts inputs periodically on SCCP7 without storing results,
+//                  so the digital comparators of ADC_ThresholdInit() can watch
+//                  them with the CPU idle. Run it with ADC_StreamStart() and
+//                  ADC_StreamStop(). Not needed for inputs that are streamed
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              samplingFreq [uint_fast32_t]: conversions per second
+//              inputs [const uint8_t *]: ANx to convert
+//              count [uint_fast8_t]: number of inputs, 1 to ADC_MAX_CHANNELS
+// @returns:    [uint_fast32_t]: actual conversion rate in Hz, 0 = count is 0
+// *****************************************************************************
+uint_fast32_t ADC_MonitorInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, const uint8_t *inputs, uint_fast8_t count);
+
+
+// *****************************************************************************
+// @desc:       Watches an input with a hardware digital comparator. Every
+//                  conversion of the input is compared, but only a crossing
+//                  interrupts: once active, the comparator is switched to the
+//                  release condition moved back by hyst, and back again once
+//                  released. The input must be converted, by a stream or by
+//                  ADC_MonitorInit()
+// @args:       n [uint_fast8_t]: comparator, 0 to ADC_THRESHOLDS - 1
+//              input [uint_fast8_t]: ANx
+//              mode [ADC_ThresholdMode]: ABOVE uses high, BELOW uses low,
+//                  INSIDE and OUTSIDE use both
+//              low [uint16_t]: lower limit, 12bit
+//              high [uint16_t]: upper limit, 12bit
+//              hyst [uint16_t]: hysteresis in LSB
+//              ThresholdHandler [func pointer]: called from the comparator ISR
+//                  with n, the new state and the converted value
+//              priority [uint_fast8_t]: interrupt priority
+// @returns:    None
+// *****************************************************************************
+void ADC_ThresholdInit(uint_fast8_t n, uint_fast8_t input, ADC_ThresholdMode mode, uint16_t low, uint16_t high, uint16_t hyst, void (* ThresholdHandler)(uint_fast8_t n, bool active, uint16_t value), uint_fast8_t priority);
+
+
+// *****************************************************************************
+// @desc:       Returns the state of a threshold
+// @args:       n [uint_fast8_t]: comparator, 0 to ADC_THRESHOLDS - 1
+// @returns:    [bool]: true = limit crossed and not yet released
+// *****************************************************************************
+bool ADC_ThresholdIsActive(uint_fast8_t n);
+
+
+// *****************************************************************************
+// @desc:       Turns a digital comparator and its interrupt off
+// @args:       n [uint_fast8_t]: comparator, 0 to ADC_THRESHOLDS - 1
+// @returns:    None
+// *****************************************************************************
+void ADC_ThresholdDisable(uint_fast8_t n);
+
+
+// *****************************************************************************
+// @desc:       Initialize an accumulate-and-dump decimator. Summing 4^n samples
+//                  and dropping n bits gains n bits of resolution, provided
+//                  the input carries at least 1 LSB of noise
+// @args:       d [ADC_Decimator *]: decimator state
+//              extraBits [uint_fast8_t]: 1 to ADC_MAX_EXTRA_BITS
+// @returns:    None
+// *****************************************************************************
+void ADC_DecimatorInit(ADC_Decimator *d, uint_fast8_t extraBits);
+
+
+// *****************************************************************************
+// @desc:       Runs a whole block through the decimator. A partial sum is kept
+//                  for the next block, so block length does not have to be a
+//                  multiple of the ratio
+// @args:       d [ADC_Decimator *]: decimator state
+//              in [const uint16_t *]: 12bit samples
+//              count [uint_fast16_t]: number of samples
+//              out [uint16_t *]: results, 12 + extraBits bits, room for
+//                  count / ratio + 1 values
+// @returns:    [uint_fast16_t]: number of results written
+// *****************************************************************************
+uint_fast16_t ADC_Decimate(ADC_Decimator *d, const uint16_t *in, uint_fast16_t count, uint16_t *out);
+
+
+// *****************************************************************************
+// @desc:       Initialize an oversampled input. The input is streamed at one
+//                  sample per ADC_OVERSAMPLE_PERIOD Fcy ticks, the fastest
+//                  rate a dedicated core keeps up with, and every half buffer
+//                  is decimated in the DMA interrupt. Use AN0 or AN1 for the
+//                  full rate. Takes over the ADC stream, run it with
+//                  ADC_StreamStart() and ADC_StreamStop()
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              input [uint_fast8_t]: ANx
+//              extraBits [uint_fast8_t]: 1 to ADC_MAX_EXTRA_BITS, results are
+//                  13 to 16bit, 0 to (4096 << extraBits) - 1
+//              buffer [uint16_t *]: raw samples in data RAM
+//              length [uint_fast16_t]: samples in buffer, even
+//              results [uint16_t *]: room for length / 2 / 4^extraBits + 1
+//                  results
+//              ResultHandler [func pointer]: called from the DMA interrupt with
+//                  the results of each half buffer
+//              priority [uint_fast8_t]: DMA interrupt priority
+// @returns:    [uint_fast32_t]: results per second
+// *****************************************************************************
+uint_fast32_t ADC_OversampleInit(bool activeOnIdle, bool activeOnSleep, uint_fast8_t input, uint_fast8_t extraBits, uint16_t *buffer, uint_fast16_t length, uint16_t *results, void (* ResultHandler)(const uint16_t *results, uint_fast16_t count), uint_fast8_t priority);
+
+
+#endif	// _NANOLAY_ADC_H
@@ -0,0 +1,82 @@
+/* ************************************************************************** */
+// Nanolay - IMA-ADPCM Library Source File
+//
+// Description:     IMA-ADPCM decoder used by the clip player of the wave
+//                  generator. Does not touch any device register so it also
+//                  compiles with a host compiler, which allows decoded output
+//                  to be compared with a PC decoder.
+//
+// Target Device:   dsPIC33CKxxxMP202, Host
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include "nanolay_adpcm.h"
+
+
+static const int8_t indexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+
+static const int16_t stepTable[ADPCM_MAX_INDEX + 1] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+
+int16_t ADPCM_ReadHeader(ADPCM_State *state, const uint8_t *header){
+    state->predictor = (int16_t) (header[0] | ((uint16_t) header[1] << 8));
+    state->index = header[2];
+    if (state->index > ADPCM_MAX_INDEX){                                        // corrupt header, keep the table in bounds
+        state->index = ADPCM_MAX_INDEX;
+    }
+    return state->predictor;
+}
+
+
+int16_t ADPCM_Decode(ADPCM_State *state, uint8_t nibble){
+    int16_t step = stepTable[state->index];
+    int32_t diff = step >> 3;
+    int32_t sample;
+    int_fast8_t index;
+
+    if (nibble & 4){
+        diff += step;
+    }
+    if (nibble & 2){
+        diff += step >> 1;
+    }
+    if (nibble & 1){
+        diff += step >> 2;
+    }
+    sample = (nibble & 8) ? (state->predictor - diff) : (state->predictor + diff);
+    if (sample > INT16_MAX){
+        sample = INT16_MAX;
+    }
+    else if (sample < INT16_MIN){
+        sample = INT16_MIN;
+    }
+    state->predictor = (int16_t) sample;
+
+    index = (int_fast8_t) state->index + indexTable[nibble & 0x0F];
+    if (index < 0){
+        index = 0;
+    }
+    else if (index > ADPCM_MAX_INDEX){
+        index = ADPCM_MAX_INDEX;
+    }
+    state->index = (uint8_t) index;
+    return state->predictor;
+}
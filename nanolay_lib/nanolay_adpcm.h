@@ -0,0 +1,55 @@
+/* ************************************************************************** */
+// Nanolay - IMA-ADPCM Library Header File
+//
+// Description:     IMA-ADPCM decoder used by the clip player of the wave
+//                  generator. Does not touch any device register so it also
+//                  compiles with a host compiler, which allows decoded output
+//                  to be compared with a PC decoder.
+//
+// Target Device:   dsPIC33CKxxxMP202, Host
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+
+#ifndef _NANOLAY_ADPCM_H
+#define	_NANOLAY_ADPCM_H
+
+
+#include <stdint.h>
+
+
+#define ADPCM_HEADER_SIZE   4                                                   // predictor (int16 LE), step index, reserved
+#define ADPCM_MAX_INDEX     88
+
+
+typedef struct adpcm_state {
+    int16_t             predictor;                                              // last decoded sample
+    uint8_t             index;                                                  // step table index, 0 to ADPCM_MAX_INDEX
+} ADPCM_State;
+
+
+// *****************************************************************************
+// @desc:       Loads the decoder state from the 4 byte header at the start of
+//                  each IMA-ADPCM block (WAV format 0x0011, mono). The
+//                  predictor is also the first sample of the block
+// @args:       state [ADPCM_State *]: decoder state
+//              header [const uint8_t *]: first byte of the block
+// @returns:    [int16_t]: first sample of the block
+// *****************************************************************************
+int16_t ADPCM_ReadHeader(ADPCM_State *state, const uint8_t *header);
+
+
+// *****************************************************************************
+// @desc:       Decodes one 4bit code. Within a byte the low nibble comes first
+// @args:       state [ADPCM_State *]: decoder state, updated
+//              nibble [uint8_t]: 4bit code, upper bits are ignored
+// @returns:    [int16_t]: decoded 16bit sample
+// *****************************************************************************
+int16_t ADPCM_Decode(ADPCM_State *state, uint8_t nibble);
+
+
+#endif	// _NANOLAY_ADPCM_H
@@ -15,6 +15,22 @@
 #include "nanolay_dac.h"
 
 DAC_Stat stat;
+DAC_Stream stream;
+DAC_Cal cal;
+void (*DAC_Cmp_InterruptHandler)(void) = NULL;
+void (*DAC_Stream_RefillHandler)(uint16_t *block, uint_fast16_t count) = NULL;
+
+
+// Clock and timing shared by DAC1-3. Set up only while the module is off, so
+// initializing one DAC again does not reset the others
+static void DAC_ModuleInit(bool activeOnIdle){
+    if (!DACCTRL1Lbits.DACON){
+        DACCTRL1L = 0x00;                                                       // CLKDIV 1:1; FCLKDIV 1:1; CLKSEL AFVCO/2 - Auxiliary VCO Clock;
+        DACCTRL1Lbits.DACSIDL = !activeOnIdle;
+        DACCTRL2L = 0x55;                                                       // TMODTIME 85;
+        DACCTRL2H = 0x8A;                                                       // SSTIME 138;
+    }
+}
 
 
 void DAC_Init(bool activeOnIdle){           
@@ -23,10 +39,7 @@ void DAC_Init(bool activeOnIdle){
     if ((clk != FOSC_8MHZ)) {
 		PMD7bits.CMP1MD = 0;													// enable CMP1 module
 
-	    DACCTRL1L = 0x00; 														// CLKDIV 1:1; DACON disabled; DACSIDL disabled; FCLKDIV 1:1; CLKSEL AFVCO/2 - Auxiliary VCO Clock;        
-		DACCTRL1Lbits.DACSIDL = !activeOnIdle;
-	    DACCTRL2L = 0x55; 														// TMODTIME 85; 
-	    DACCTRL2H = 0x8A; 														// SSTIME 138; 
+		DAC_ModuleInit(activeOnIdle);
 	    DAC1CONH = 0x00; 														// TMCB 0; 
 	    DAC1CONL = 0x00; 
 
@@ -46,7 +59,31 @@ void DAC_Init(bool activeOnIdle){
 }
 
 
+static inline uint16_t DAC_Clamp(uint_fast16_t val){
+    if (val < MIN_DAC_VAL){
+        return MIN_DAC_VAL;
+    }
+    else if (val > MAX_DAC_VAL){
+        return MAX_DAC_VAL;
+    }
+    return val;
+}
+
+
+static inline int16_t DAC_CalCorrection(uint_fast16_t val){
+    const int16_t *t;
+
+    val = DAC_Clamp(val);                                                       // hold the correction outside the measured window
+    t = &cal.table[val >> DAC_CAL_SHIFT];
+    return t[0] + (int16_t) (((int32_t) (t[1] - t[0]) * (int16_t) (val & ((1 << DAC_CAL_SHIFT) - 1))) >> DAC_CAL_SHIFT);
+}
+
+
 void DAC_Write(uint_fast16_t val){
+	if (stat.calEn){
+		DAC1DATHbits.DACDAT = DAC_CalApply(val);
+		return;
+	}
     if (val < MIN_DAC_VAL){
 		DAC1DATHbits.DACDAT = MIN_DAC_VAL;
 		return;
@@ -62,3 +99,454 @@ void DAC_Write(uint_fast16_t val){
 }
 
 
+uint16_t DAC_CalApply(uint_fast16_t val){
+    int_fast16_t corrected;
+
+    if (!stat.calEn){
+        return DAC_Clamp(val);
+    }
+    corrected = (int_fast16_t) val + DAC_CalCorrection(val);
+
+    if (corrected < MIN_DAC_VAL){
+        return MIN_DAC_VAL;
+    }
+    else if (corrected > MAX_DAC_VAL){
+        return MAX_DAC_VAL;
+    }
+    return corrected;
+}
+
+
+void DAC_CmpInit(bool activeOnIdle, DAC_CmpInput input, DAC_CmpHyst hyst, bool invert, bool filterEn, uint_fast16_t threshold){
+    DAC_ChannelInit(DAC_1, activeOnIdle, false);
+    if (!stat.dac1En){
+        return;
+    }
+
+    IEC4bits.CMP1IE = false;
+    DAC1CONLbits.DACEN = 0;                                                     // hold the comparator while it is set up
+    DAC1CONLbits.INSEL = input;
+    DAC1CONLbits.HYSSEL = hyst;
+    DAC1CONLbits.HYSPOL = 0;                                                    // hysteresis on the rising edge
+    DAC1CONLbits.CMPPOL = invert;
+    DAC1CONLbits.FLTREN = filterEn;
+    DAC1CONLbits.IRQM = DAC_CMP_EDGE_NONE;
+    DAC1DATH = DAC_CalApply(threshold);
+    DAC1CONLbits.DACEN = 1;
+}
+
+
+void DAC_CmpSetThreshold(uint_fast16_t threshold){
+    DAC1DATHbits.DACDAT = DAC_CalApply(threshold);
+}
+
+
+bool DAC_CmpGetStatus(void){
+    return DAC1CONLbits.CMPSTAT;
+}
+
+
+void DAC_CmpSetInterrupt(DAC_CmpEdge edge, void (* InterruptHandler)(void), uint_fast8_t priority){
+    IEC4bits.CMP1IE = false;
+    DAC1CONLbits.IRQM = edge;
+    DAC_Cmp_InterruptHandler = InterruptHandler;
+    IPC19bits.CMP1IP = priority;
+    IFS4bits.CMP1IF = false;
+    IEC4bits.CMP1IE = (edge != DAC_CMP_EDGE_NONE);
+}
+
+
+void DAC_CmpSetPWMTrip(uint_fast8_t generator, bool cycleByCycle){
+    if (cycleByCycle){
+        switch ( generator ){
+            case 1:
+                PG1CLPCIL = 0x00;
+                PG1CLPCIH = 0x00;
+                PG1CLPCILbits.PSS = DAC_CMP1_PSS;
+                PG1CLPCILbits.TERM = 0b001;                                     // auto terminate once the comparator output is low
+                PG1CLPCIHbits.ACP = 0b100;                                      // latched rising edge
+                PG1IOCONLbits.CLDAT = 0b00;                                     // PWMxH and PWMxL low while active
+                break;
+            case 2:
+                PG2CLPCIL = 0x00;
+                PG2CLPCIH = 0x00;
+                PG2CLPCILbits.PSS = DAC_CMP1_PSS;
+                PG2CLPCILbits.TERM = 0b001;                                     // auto terminate once the comparator output is low
+                PG2CLPCIHbits.ACP = 0b100;                                      // latched rising edge
+                PG2IOCONLbits.CLDAT = 0b00;                                     // PWMxH and PWMxL low while active
+                break;
+            case 3:
+                PG3CLPCIL = 0x00;
+                PG3CLPCIH = 0x00;
+                PG3CLPCILbits.PSS = DAC_CMP1_PSS;
+                PG3CLPCILbits.TERM = 0b001;                                     // auto terminate once the comparator output is low
+                PG3CLPCIHbits.ACP = 0b100;                                      // latched rising edge
+                PG3IOCONLbits.CLDAT = 0b00;                                     // PWMxH and PWMxL low while active
+                break;
+            case 4:
+                PG4CLPCIL = 0x00;
+                PG4CLPCIH = 0x00;
+                PG4CLPCILbits.PSS = DAC_CMP1_PSS;
+                PG4CLPCILbits.TERM = 0b001;                                     // auto terminate once the comparator output is low
+                PG4CLPCIHbits.ACP = 0b100;                                      // latched rising edge
+                PG4IOCONLbits.CLDAT = 0b00;                                     // PWMxH and PWMxL low while active
+                break;
+            default:
+                break;
+        }
+    }
+    else {
+        switch ( generator ){
+            case 1:
+                PG1FPCIL = 0x00;
+                PG1FPCIH = 0x00;
+                PG1FPCILbits.PSS = DAC_CMP1_PSS;
+                PG1FPCIHbits.ACP = 0b100;                                       // latched rising edge, TERM manual
+                PG1IOCONLbits.FLTDAT = 0b00;
+                break;
+            case 2:
+                PG2FPCIL = 0x00;
+                PG2FPCIH = 0x00;
+                PG2FPCILbits.PSS = DAC_CMP1_PSS;
+                PG2FPCIHbits.ACP = 0b100;                                       // latched rising edge, TERM manual
+                PG2IOCONLbits.FLTDAT = 0b00;
+                break;
+            case 3:
+                PG3FPCIL = 0x00;
+                PG3FPCIH = 0x00;
+                PG3FPCILbits.PSS = DAC_CMP1_PSS;
+                PG3FPCIHbits.ACP = 0b100;                                       // latched rising edge, TERM manual
+                PG3IOCONLbits.FLTDAT = 0b00;
+                break;
+            case 4:
+                PG4FPCIL = 0x00;
+                PG4FPCIH = 0x00;
+                PG4FPCILbits.PSS = DAC_CMP1_PSS;
+                PG4FPCIHbits.ACP = 0b100;                                       // latched rising edge, TERM manual
+                PG4IOCONLbits.FLTDAT = 0b00;
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _CMP1Interrupt (void){
+    IFS4bits.CMP1IF = false;
+    if (DAC_Cmp_InterruptHandler != NULL){
+        DAC_Cmp_InterruptHandler();
+    }
+}
+
+
+bool DAC_CalMeasure(uint16_t (* Measure)(uint_fast16_t code)){
+    int16_t code[DAC_CAL_POINTS];
+    int16_t measured[DAC_CAL_POINTS];
+    int16_t table[DAC_CAL_POINTS];
+    int16_t line, dev, inl = 0;
+    int32_t gain;
+    uint_fast8_t i;
+
+    for (i = 0; i < DAC_CAL_POINTS; i++){
+        code[i] = DAC_Clamp((uint_fast16_t) i << DAC_CAL_SHIFT);                // end points are measured at the window limits
+        DAC1DATHbits.DACDAT = code[i];
+        measured[i] = Measure(code[i]);
+        table[i] = code[i] - measured[i];
+        if ((table[i] > DAC_CAL_MAX_CORR) || (table[i] < -DAC_CAL_MAX_CORR)){
+            DAC1DATHbits.DACDAT = DAC_MIDSCALE;
+            return false;
+        }
+    }
+    DAC1DATHbits.DACDAT = DAC_MIDSCALE;
+
+    // gain/offset line through the two end points, INL is what is left over
+    gain = (((int32_t) (measured[DAC_CAL_POINTS - 1] - measured[0])) << 14) / (code[DAC_CAL_POINTS - 1] - code[0]);
+    cal.gain = gain;
+    cal.offset = measured[0] - (int16_t) ((gain * code[0]) >> 14);
+    for (i = 0; i < DAC_CAL_POINTS; i++){
+        line = cal.offset + (int16_t) ((gain * code[i]) >> 14);
+        dev = (measured[i] > line) ? (measured[i] - line) : (line - measured[i]);
+        if (dev > inl){
+            inl = dev;
+        }
+        cal.table[i] = table[i];
+    }
+    // the end points were measured inside the window, not at codes 0 and 4096.
+    // Continue the end segments to the grid so the interpolation is exact
+    // between the measured points, codes outside are held at the window limits
+    cal.table[0] = table[1] + (int16_t) ((((int32_t) (table[0] - table[1])) << DAC_CAL_SHIFT) / (code[1] - code[0]));
+    cal.table[DAC_CAL_POINTS - 1] = table[DAC_CAL_POINTS - 2] + (int16_t) ((((int32_t) (table[DAC_CAL_POINTS - 1] - table[DAC_CAL_POINTS - 2])) << DAC_CAL_SHIFT) / (code[DAC_CAL_POINTS - 1] - code[DAC_CAL_POINTS - 2]));
+    cal.inl = inl;
+    stat.calEn = true;
+    return true;
+}
+
+
+void DAC_CalLoad(const DAC_Cal *data){
+    cal = *data;
+    stat.calEn = true;
+}
+
+
+const DAC_Cal *DAC_CalGet(void){
+    return &cal;
+}
+
+
+void DAC_CalEnable(bool enable){
+    stat.calEn = enable;
+}
+
+
+void DAC_ChannelInit(DAC_Channel ch, bool activeOnIdle, bool outputEn){
+    if (Sys_GetMasterClkFreq() == FOSC_8MHZ){
+        return;
+    }
+
+    switch ( ch ){
+        case DAC_1:
+            PMD7bits.CMP1MD = 0;                                                // enable CMP1 module
+            DAC1CONH = 0x00;                                                    // TMCB 0;
+            DAC1CONL = 0x00;
+            SLP1CONH = 0x00;                                                    // HME disabled; PSE Negative; SLOPEN disabled; TWME disabled;
+            SLP1CONL = 0x00;
+            SLP1DAT = 0x00;
+            DAC1DATL = 0x00;
+            DAC1DATH = DAC_MIDSCALE;
+            DAC1CONLbits.DACEN = 1;
+            stat.dac1En = true;
+            break;
+        case DAC_2:
+            PMD7bits.CMP2MD = 0;                                                // enable CMP2 module
+            DAC2CONH = 0x00;
+            DAC2CONL = 0x00;
+            SLP2CONH = 0x00;
+            SLP2CONL = 0x00;
+            SLP2DAT = 0x00;
+            DAC2DATL = 0x00;
+            DAC2DATH = DAC_MIDSCALE;
+            DAC2CONLbits.DACEN = 1;
+            stat.dac2En = true;
+            break;
+        case DAC_3:
+            PMD7bits.CMP3MD = 0;                                                // enable CMP3 module
+            DAC3CONH = 0x00;
+            DAC3CONL = 0x00;
+            SLP3CONH = 0x00;
+            SLP3CONL = 0x00;
+            SLP3DAT = 0x00;
+            DAC3DATL = 0x00;
+            DAC3DATH = DAC_MIDSCALE;
+            DAC3CONLbits.DACEN = 1;
+            stat.dac3En = true;
+            break;
+    }
+
+    if (outputEn){                                                              // only one DAC may drive DACOUT1
+        DAC1CONLbits.DACOEN = (ch == DAC_1);
+        DAC2CONLbits.DACOEN = (ch == DAC_2);
+        DAC3CONLbits.DACOEN = (ch == DAC_3);
+    }
+
+    DAC_ModuleInit(activeOnIdle);
+    DACCTRL1Lbits.DACON = 1;
+}
+
+
+void DAC_WriteChannel(DAC_Channel ch, uint_fast16_t val){
+    switch ( ch ){
+        case DAC_1:
+            DAC1DATHbits.DACDAT = DAC_CalApply(val);
+            break;
+        case DAC_2:
+            DAC2DATHbits.DACDAT = DAC_Clamp(val);
+            break;
+        case DAC_3:
+            DAC3DATHbits.DACDAT = DAC_Clamp(val);
+            break;
+    }
+}
+
+
+void DAC_WriteSync(const uint16_t *vals){
+    uint16_t v1 = DAC_CalApply(vals[0]);
+    uint16_t v2 = DAC_Clamp(vals[1]);
+    uint16_t v3 = DAC_Clamp(vals[2]);
+
+    __builtin_disi(0x3FFF);                                                     // hold off interrupts up to priority 6
+    DAC1DATH = v1;                                                              // whole register writes, one instruction each
+    DAC2DATH = v2;
+    DAC3DATH = v3;
+    DISICNT = 0x0000;
+}
+
+
+static volatile uint16_t *DAC_DataReg(DAC_Channel ch){
+    switch ( ch ){
+        case DAC_2:
+            return &DAC2DATH;
+        case DAC_3:
+            return &DAC3DATH;
+        default:
+            return &DAC1DATH;
+    }
+}
+
+
+void DAC_WritePair(DAC_Channel chA, uint_fast16_t valA, DAC_Channel chB, uint_fast16_t valB){
+    volatile uint16_t *regA = DAC_DataReg(chA);
+    volatile uint16_t *regB = DAC_DataReg(chB);
+    uint16_t a = (chA == DAC_1) ? DAC_CalApply(valA) : DAC_Clamp(valA);
+    uint16_t b = (chB == DAC_1) ? DAC_CalApply(valB) : DAC_Clamp(valB);
+
+    __builtin_disi(0x3FFF);
+    *regA = a;
+    *regB = b;
+    DISICNT = 0x0000;
+}
+
+
+void DAC_WriteDifferential(DAC_Channel pos, DAC_Channel neg, uint_fast16_t common, int_fast16_t diff){
+    int_fast16_t half = diff / 2;
+
+    DAC_WritePair(pos, (uint_fast16_t) ((int_fast16_t) common + half), neg, (uint_fast16_t) ((int_fast16_t) common - half));
+}
+
+
+void DAC_ClampBlock(uint16_t *block, uint_fast16_t count){
+    uint16_t val;
+
+    if (stat.calEn){
+        while (count--){
+            *block = DAC_CalApply(*block);
+            block++;
+        }
+        return;
+    }
+    while (count--){
+        val = *block;
+        val = (val < MIN_DAC_VAL) ? MIN_DAC_VAL : val;
+        val = (val > MAX_DAC_VAL) ? MAX_DAC_VAL : val;
+        *block++ = val;
+    }
+}
+
+
+static void DAC_Stream_DMAHandler(bool half){
+    uint_fast8_t done = half ? 0 : 1;                                           // half = first half was played out
+    uint16_t *block = stream.buffer + (done * stream.halfLength);
+
+    if (stream.mode == DAC_STREAM_CALLBACK){
+        DAC_Stream_RefillHandler(block, stream.halfLength);
+        DAC_ClampBlock(block, stream.halfLength);
+    }
+    else {
+        stream.ready[done] = false;
+        if (!stream.ready[done ^ 1]){                                           // the other half is now playing stale samples
+            stream.underruns++;
+        }
+    }
+}
+
+
+uint_fast32_t DAC_StreamInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, uint16_t *buffer, uint_fast16_t length, DAC_StreamMode mode, void (* RefillHandler)(uint16_t *block, uint_fast16_t count)){
+    uint32_t clock = SCCP_GetClkFreq();
+    uint32_t period;
+    uint_fast16_t i;
+
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+
+    if (samplingFreq == 0){
+        samplingFreq = 1;
+    }
+    period = (clock + (samplingFreq / 2)) / samplingFreq;
+    if (period < SCCP8_MIN_PERIOD){
+        period = SCCP8_MIN_PERIOD;
+    }
+    stream.samplingFrequency = (clock + (period / 2)) / period;
+
+    if ((mode == DAC_STREAM_CALLBACK) && (RefillHandler == NULL)){
+        mode = DAC_STREAM_LOOP;
+    }
+    stream.mode = mode;
+    stream.buffer = buffer;
+    stream.halfLength = length / 2;
+    stream.ready[0] = false;
+    stream.ready[1] = false;
+    stream.next = 0;
+    stream.underruns = 0;
+    DAC_Stream_RefillHandler = RefillHandler;
+
+    if (mode == DAC_STREAM_QUEUE){
+        for (i = 0; i < length; i++){
+            buffer[i] = DAC_MIDSCALE;
+        }
+    }
+    else {
+        DAC_ClampBlock(buffer, length);
+    }
+
+    DMA_ChannelInit(DAC_STREAM_DMA_CH, DMA_TRIG_SCCP8_TMR, buffer, DMA_ADDR_INC, &DAC1DATH, DMA_ADDR_FIXED, length, DMA_REPEATED_ONESHOT);
+    if (mode != DAC_STREAM_LOOP){
+        DMA_SetInterrupt(DAC_STREAM_DMA_CH, true, DAC_Stream_DMAHandler, DAC_STREAM_PRIORITY);
+    }
+    SCCP8_Init(activeOnIdle, activeOnSleep, period, DAC_STREAM_PRIORITY);       // CCT8 interrupt stays disabled, the event only triggers DMA
+    return stream.samplingFrequency;
+}
+
+
+bool DAC_WriteBlock(const uint16_t *data, uint_fast16_t count){
+    uint16_t *block;
+    uint16_t val = DAC_MIDSCALE;
+    uint_fast16_t i;
+
+    if ((stream.mode != DAC_STREAM_QUEUE) || stream.ready[stream.next] || (count == 0)){
+        return false;
+    }
+    if (count > stream.halfLength){
+        count = stream.halfLength;
+    }
+    block = stream.buffer + (stream.next * stream.halfLength);
+
+    for (i = 0; i < count; i++){                                                // copy, correct and clamp in one pass
+        val = DAC_CalApply(data[i]);
+        block[i] = val;
+    }
+    for ( ; i < stream.halfLength; i++){
+        block[i] = val;
+    }
+    stream.ready[stream.next] = true;
+    stream.next ^= 1;
+    return true;
+}
+
+
+void DAC_StreamStart(void){
+    DMA_Start(DAC_STREAM_DMA_CH);
+    CCP8CON1Lbits.CCPON = true;
+}
+
+
+void DAC_StreamStop(void){
+    CCP8CON1Lbits.CCPON = false;
+    DMA_Stop(DAC_STREAM_DMA_CH);
+}
+
+
+uint32_t DAC_GetClkFreq(void){
+    uint_fast8_t prescaler = ACLKCON1bits.APLLPRE;
+    uint32_t vco;
+
+    if (prescaler == 0){
+        prescaler = 1;
+    }
+    vco = (DAC_FRC_FREQ / prescaler) * APLLFBD1bits.APLLFBDIV;                  // AFVCO, 1.6GHz with the Sys_ClockSet() settings
+    return (vco / 2) / (DACCTRL1Lbits.CLKDIV + 1);                              // CLKSEL AFVCO/2 as set by DAC_Init()
+}
+
+
+uint32_t DAC_GetUnderruns(void){
+    return stream.underruns;
+}
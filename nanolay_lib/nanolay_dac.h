@@ -22,15 +22,83 @@
 
 #define MIN_DAC_VAL     205
 #define MAX_DAC_VAL     3890
+#define DAC_FRC_FREQ    8000000UL                                               // auxiliary PLL input, Sys_ClockSet() selects the FRC
+#define DAC_SLP_FRAC_BITS   4                                                   // SLPxDAT is 12.4 fixed point, LSB per DAC clock
+#define DAC_MIDSCALE    0x0800
+#define DAC_STREAM_DMA_CH   DMA_CH0                                             // DMA channel used by the DAC stream
+#define DAC_STREAM_PRIORITY 2
+#define DAC_CHANNELS    3
+#define DAC_CAL_SHIFT   8                                                       // calibration points every 256 codes
+#define DAC_CAL_POINTS  ((4096 >> DAC_CAL_SHIFT) + 1)
+#define DAC_CMP1_PSS    0b11100                                                 // PWM PCI source select code of the CMP1 output
+#define DAC_CAL_MAX_CORR    256                                                 // larger corrections are rejected as a bad measurement
 
 
 typedef struct dac_stat {
     bool    dac1En;
     bool    dac2En;
     bool    dac3En;
+    bool    calEn;                                                              // DAC1 values go through the calibration table
 } DAC_Stat;
 
 
+typedef struct dac_cal {
+    int16_t     offset;                                                         // output at code 0 of the gain/offset line, LSB
+    int16_t     gain;                                                           // slope of the gain/offset line, Q14, 0x4000 = 1.0
+    int16_t     inl;                                                            // largest deviation from that line, LSB
+    int16_t     table[DAC_CAL_POINTS];                                          // correction at code n << DAC_CAL_SHIFT, LSB, end entries continue the end segments
+} DAC_Cal;
+
+
+typedef enum dac_channel {
+    DAC_1 = 0,
+    DAC_2 = 1,
+    DAC_3 = 2
+} DAC_Channel;
+
+
+typedef enum dac_cmp_input {
+    DAC_CMP_INPUT_A = 0,                                                        // CMP1A
+    DAC_CMP_INPUT_B = 1,                                                        // CMP1B
+    DAC_CMP_INPUT_C = 2,                                                        // CMP1C
+    DAC_CMP_INPUT_D = 3                                                         // CMP1D
+} DAC_CmpInput;
+
+
+typedef enum dac_cmp_hyst {
+    DAC_CMP_HYST_NONE = 0,
+    DAC_CMP_HYST_15MV = 1,
+    DAC_CMP_HYST_30MV = 2,
+    DAC_CMP_HYST_45MV = 3
+} DAC_CmpHyst;
+
+
+typedef enum dac_cmp_edge {
+    DAC_CMP_EDGE_NONE = 0,
+    DAC_CMP_EDGE_RISING = 1,
+    DAC_CMP_EDGE_FALLING = 2,
+    DAC_CMP_EDGE_BOTH = 3
+} DAC_CmpEdge;
+
+
+typedef enum dac_stream_mode {
+    DAC_STREAM_LOOP = 0,                                                        // buffer is replayed as is, no CPU involvement
+    DAC_STREAM_QUEUE = 1,                                                       // halves are queued with DAC_WriteBlock()
+    DAC_STREAM_CALLBACK = 2                                                     // halves are refilled by a callback
+} DAC_StreamMode;
+
+
+typedef struct dac_stream {
+    DAC_StreamMode      mode;
+    uint16_t            *buffer;
+    uint_fast16_t       halfLength;
+    volatile bool       ready[2];                                               // QUEUE: half holds samples not yet played
+    uint_fast8_t        next;                                                   // QUEUE: half DAC_WriteBlock() fills next
+    volatile uint32_t   underruns;                                              // QUEUE: halves started with no new data
+    uint_fast32_t       samplingFrequency;                                      // actual sampling frequency in Hz
+} DAC_Stream;
+
+
 // *****************************************************************************
 // @desc:       Initialize DAC1 module. Enables DACOUT pin at PA3/RA3/AN3.
 //                  Works only at Fosc = 20MHz and above
@@ -48,5 +116,271 @@ void DAC_Init(bool activeOnIdle);
 void DAC_Write(uint_fast16_t val);
 
 
+// *****************************************************************************
+// @desc:       Initialize one of the three DAC modules. The device has a single
+//                  DACOUT1 pin (PA3/RA3/AN3) that any one DAC can drive, the
+//                  other DACs feed their comparator only, e.g. as thresholds.
+//                  Output starts at DAC_MIDSCALE.
+//                  Works only at Fosc = 20MHz and above
+// @args:       ch [DAC_Channel]: DAC_1, DAC_2 or DAC_3
+//              activeOnIdle [bool]: true = continues operation in Idle mode
+//              outputEn [bool]: true = drive DACOUT1, which releases the pin
+//                  from the other DACs
+// @returns:    None
+// *****************************************************************************
+void DAC_ChannelInit(DAC_Channel ch, bool activeOnIdle, bool outputEn);
+
+
+// *****************************************************************************
+// @desc:       Outputs a 12bit value on one DAC, clamped like DAC_Write()
+// @args:       ch [DAC_Channel]: DAC_1, DAC_2 or DAC_3
+//              val [uint_fast16_t]: 12bit DAC value
+// @returns:    None
+// *****************************************************************************
+void DAC_WriteChannel(DAC_Channel ch, uint_fast16_t val);
+
+
+// *****************************************************************************
+// @desc:       Updates all three DACs together. Values are clamped first, then
+//                  written with interrupts held off in three consecutive
+//                  instructions, so no ISR can run between the updates
+// @args:       vals [const uint16_t *]: DAC_CHANNELS values, DAC_1 first
+// @returns:    None
+// *****************************************************************************
+void DAC_WriteSync(const uint16_t *vals);
+
+
+// *****************************************************************************
+// @desc:       Updates two DACs together, e.g. an I/Q pair, the same way as
+//                  DAC_WriteSync()
+// @args:       chA [DAC_Channel]: first DAC
+//              valA [uint_fast16_t]: 12bit value of chA
+//              chB [DAC_Channel]: second DAC
+//              valB [uint_fast16_t]: 12bit value of chB
+// @returns:    None
+// *****************************************************************************
+void DAC_WritePair(DAC_Channel chA, uint_fast16_t valA, DAC_Channel chB, uint_fast16_t valB);
+
+
+// *****************************************************************************
+// @desc:       Drives two DACs as a differential pair around a common level,
+//                  pos = common + diff / 2 and neg = common - diff / 2, updated
+//                  together. The same call sets the two thresholds of a window
+//                  comparator centered on common
+// @args:       pos [DAC_Channel]: positive DAC
+//              neg [DAC_Channel]: negative DAC
+//              common [uint_fast16_t]: common mode level, 12bit
+//              diff [int_fast16_t]: pos - neg in DAC LSB
+// @returns:    None
+// *****************************************************************************
+void DAC_WriteDifferential(DAC_Channel pos, DAC_Channel neg, uint_fast16_t common, int_fast16_t diff);
+
+
+// *****************************************************************************
+// @desc:       Initialize comparator CMP1 with DAC1 as its threshold, e.g. for
+//                  cycle by cycle current limiting. The output is high while
+//                  the input is above the threshold, unless inverted. The
+//                  input pin must be set up as analog input by the caller.
+//                  Works only at Fosc = 20MHz and above
+// @args:       activeOnIdle [bool]: true = continues operation in Idle mode
+//              input [DAC_CmpInput]: CMP1A to CMP1D
+//              hyst [DAC_CmpHyst]: hysteresis, applied to the rising edge
+//              invert [bool]: true = output high while input is below
+//              filterEn [bool]: true = digital filter on the output, adds a
+//                  few DAC clocks of delay but rejects glitches
+//              threshold [uint_fast16_t]: 12bit DAC1 value
+// @returns:    None
+// *****************************************************************************
+void DAC_CmpInit(bool activeOnIdle, DAC_CmpInput input, DAC_CmpHyst hyst, bool invert, bool filterEn, uint_fast16_t threshold);
+
+
+// *****************************************************************************
+// @desc:       Changes the comparator threshold. Goes through DAC_CalApply()
+// @args:       threshold [uint_fast16_t]: 12bit DAC1 value
+// @returns:    None
+// *****************************************************************************
+void DAC_CmpSetThreshold(uint_fast16_t threshold);
+
+
+// *****************************************************************************
+// @desc:       Returns the comparator output
+// @args:       None
+// @returns:    [bool]: true = comparator output high
+// *****************************************************************************
+bool DAC_CmpGetStatus(void);
+
+
+// *****************************************************************************
+// @desc:       Sets up the CMP1 interrupt
+// @args:       edge [DAC_CmpEdge]: output edge that interrupts,
+//                  DAC_CMP_EDGE_NONE disables the interrupt
+//              InterruptHandler [func pointer]: called from the CMP1 ISR
+//              priority [uint_fast8_t]: interrupt priority
+// @returns:    None
+// *****************************************************************************
+void DAC_CmpSetInterrupt(DAC_CmpEdge edge, void (* InterruptHandler)(void), uint_fast8_t priority);
+
+
+// *****************************************************************************
+// @desc:       Routes the comparator output to a PWM generator as a PCI source,
+//                  so the PWM outputs are overridden in hardware without any
+//                  CPU involvement. Outputs are driven low while active. The
+//                  PWM generator itself is configured by the caller
+// @args:       generator [uint_fast8_t]: PWM generator, 1 to 4
+//              cycleByCycle [bool]: true = current limit PCI, latched on the
+//                  rising edge and released at the start of the next PWM cycle
+//                  once the output is low again. false = fault PCI, latched
+//                  until cleared by software through PGxFPCIL.SWTERM
+// @returns:    None
+// *****************************************************************************
+void DAC_CmpSetPWMTrip(uint_fast8_t generator, bool cycleByCycle);
+
+
+// *****************************************************************************
+// @desc:       Measures DAC1 gain, offset and INL and enables the correction.
+//                  DAC1 is stepped through DAC_CAL_POINTS codes, limited to
+//                  MIN_DAC_VAL..MAX_DAC_VAL, and Measure is called at each.
+//                  The correction at each point is code - measured value and
+//                  is linearly interpolated in between. Codes outside the
+//                  window get the correction at its limit, so the end segments
+//                  are never extrapolated. DAC1 must be initialized and no
+//                  waveform may be running
+// @args:       Measure [func pointer]: sets up and waits for the DAC output,
+//                  e.g. reads AN3 back with the ADC, and returns the output in
+//                  ideal DAC codes (0 = AVSS, 4096 = AVDD)
+// @returns:    [bool]: true = calibration enabled, false = a correction was
+//                  above DAC_CAL_MAX_CORR, calibration left unchanged
+// *****************************************************************************
+bool DAC_CalMeasure(uint16_t (* Measure)(uint_fast16_t code));
+
+
+// *****************************************************************************
+// @desc:       Loads a calibration saved from DAC_CalGet(), e.g. kept in flash,
+//                  and enables it
+// @args:       cal [const DAC_Cal *]: calibration data
+// @returns:    None
+// *****************************************************************************
+void DAC_CalLoad(const DAC_Cal *cal);
+
+
+// *****************************************************************************
+// @desc:       Returns the current calibration data
+// @args:       None
+// @returns:    [const DAC_Cal *]: gain, offset, INL and correction table
+// *****************************************************************************
+const DAC_Cal *DAC_CalGet(void);
+
+
+// *****************************************************************************
+// @desc:       Turns the DAC1 correction on or off. When on, DAC_Write(),
+//                  DAC1 writes of the indexed API, DAC_ClampBlock() and the
+//                  DAC stream correct each value before clamping it. The wave
+//                  generator folds the correction into its sine table,
+//                  midscale and mix scale when a generator is initialized, so
+//                  call this before the generator's Init function. Arbitrary
+//                  waveform tables are written as they are, build them with
+//                  DAC_CalApply()
+// @args:       enable [bool]: true = apply calibration
+// @returns:    None
+// *****************************************************************************
+void DAC_CalEnable(bool enable);
+
+
+// *****************************************************************************
+// @desc:       Corrects and clamps one DAC1 value. Used to fold the correction
+//                  into precomputed tables and limits, so it costs nothing
+//                  while the waveform runs
+// @args:       val [uint_fast16_t]: 12bit DAC value
+// @returns:    [uint16_t]: value to write to DAC1, MIN_DAC_VAL..MAX_DAC_VAL,
+//                  only clamped while calibration is off
+// *****************************************************************************
+uint16_t DAC_CalApply(uint_fast16_t val);
+
+
+// *****************************************************************************
+// @desc:       Limits a block of DAC values to MIN_DAC_VAL..MAX_DAC_VAL in one
+//                  pass, the per buffer counterpart of DAC_Write(). Applies the
+//                  calibration first when it is enabled. Used by the DAC
+//                  stream, build WAV_Arb_Init() tables with DAC_CalApply()
+// @args:       block [uint16_t *]: DAC values, clamped in place
+//              count [uint_fast16_t]: number of values
+// @returns:    None
+// *****************************************************************************
+void DAC_ClampBlock(uint16_t *block, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Initialize timer paced output to DAC1, pin PA3/RA3/AN3. SCCP8
+//                  triggers a DMA channel that copies buffer into DAC1DATH,
+//                  so there is no per sample interrupt. buffer is used as a
+//                  ping-pong pair of halves. Shares SCCP8 with the wave
+//                  generator, only one of them can run at a time.
+//                  Works only at Fosc = 20MHz and above
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz, rounded
+//                  to a whole number of Fcy ticks
+//              buffer [uint16_t *]: DAC samples in data RAM, must stay valid
+//                  while streaming. Set to midscale in DAC_STREAM_QUEUE mode
+//              length [uint_fast16_t]: number of samples in buffer, even
+//              mode [DAC_StreamMode]: DAC_STREAM_LOOP, DAC_STREAM_QUEUE or
+//                  DAC_STREAM_CALLBACK
+//              RefillHandler [func pointer]: DAC_STREAM_CALLBACK only, called
+//                  from the DMA interrupt with the half that was just played
+//                  out and its sample count. The half is clamped after the
+//                  callback returns
+// @returns:    [uint_fast32_t]: actual sampling frequency in Hz
+// *****************************************************************************
+uint_fast32_t DAC_StreamInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, uint16_t *buffer, uint_fast16_t length, DAC_StreamMode mode, void (* RefillHandler)(uint16_t *block, uint_fast16_t count));
+
+
+// *****************************************************************************
+// @desc:       Queues one half buffer of samples in DAC_STREAM_QUEUE mode. The
+//                  samples are clamped while they are copied. A shorter block
+//                  is padded with its last sample. If a half starts playing
+//                  before it was written, the old samples are replayed and
+//                  counted as an underrun
+// @args:       data [const uint16_t *]: DAC values
+//              count [uint_fast16_t]: number of values, up to length / 2
+// @returns:    [bool]: true = queued, false = both halves are still pending
+// *****************************************************************************
+bool DAC_WriteBlock(const uint16_t *data, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Starts the DAC stream
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void DAC_StreamStart(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the DAC stream. The DAC holds the last sample
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void DAC_StreamStop(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the DAC/slope generator clock, AFVCO/2 divided by
+//                  DACCTRL1L.CLKDIV, derived from the auxiliary PLL registers
+//                  written by Sys_ClockSet()
+// @args:       None
+// @returns:    [uint32_t]: clock frequency in Hz
+// *****************************************************************************
+uint32_t DAC_GetClkFreq(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the number of halves that started playing without new
+//                  data in DAC_STREAM_QUEUE mode
+// @args:       None
+// @returns:    [uint32_t]: underrun count
+// *****************************************************************************
+uint32_t DAC_GetUnderruns(void);
+
+
 #endif	// NANOLAY_DAC_H
 
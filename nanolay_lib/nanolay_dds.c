@@ -0,0 +1,96 @@
+/* ************************************************************************** */
+// Nanolay - DDS Math Library Source File
+//
+// Description:     Direct Digital Synthesis (DDS) phase accumulator and tuning
+//                  word math used by the wave generator. Does not touch any
+//                  device register so it also compiles with a host compiler,
+//                  which allows frequency error to be checked on a PC.
+//
+// Target Device:   dsPIC33CKxxxMP202, Host
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include "nanolay_dds.h"
+
+
+uint32_t DDS_TuningWord(uint32_t freq_mHz, uint32_t samplingFreq){
+    uint64_t den = (uint64_t) samplingFreq * DDS_MILLIHZ_PER_HZ;
+
+    if (den == 0){
+        return 0;
+    }
+    return (uint32_t) ((((uint64_t) freq_mHz << 32) + (den >> 1)) / den);       // truncated to 32bit, frequencies above Fs alias like the hardware would
+}
+
+
+uint32_t DDS_Frequency(uint32_t tuningWord, uint32_t samplingFreq){
+    uint64_t num = (uint64_t) tuningWord * samplingFreq * DDS_MILLIHZ_PER_HZ;
+
+    return (uint32_t) ((num + (1ULL << 31)) >> 32);
+}
+
+
+// (num << 32) / den by shift and subtract, so neither side overflows 64bit.
+// Returns the truncated quotient, *rem gets the remainder
+static uint32_t DDS_Divide(uint64_t num, uint64_t den, uint64_t *rem){
+    uint32_t q = (uint32_t) (num / den);                                        // whole cycles per sample, wraps like the hardware
+    uint64_t r = num % den;
+    uint_fast8_t i;
+
+    for (i = 0; i < 32; i++){
+        r <<= 1;
+        q <<= 1;
+        if (r >= den){
+            r -= den;
+            q |= 1;
+        }
+    }
+    *rem = r;
+    return q;
+}
+
+
+uint32_t DDS_TuningWordPeriod(uint32_t freq_mHz, uint32_t period, uint32_t clockFreq){
+    uint64_t den = (uint64_t) clockFreq * DDS_MILLIHZ_PER_HZ;
+    uint64_t rem;
+    uint32_t word;
+
+    if (den == 0){
+        return 0;
+    }
+    word = DDS_Divide((uint64_t) freq_mHz * period, den, &rem);
+    if (rem >= den - rem){                                                      // round to nearest
+        word++;
+    }
+    return word;
+}
+
+
+uint32_t DDS_FrequencyPeriod(uint32_t tuningWord, uint32_t period, uint32_t clockFreq){
+    uint64_t rate;
+
+    if (period == 0){
+        return 0;
+    }
+    rate = ((uint64_t) tuningWord * clockFreq) / period;                        // Hz * 2^32
+    return (uint32_t) (((rate >> 1) * (DDS_MILLIHZ_PER_HZ / 8) + (1ULL << 27)) >> 28);
+}
+
+
+uint32_t DDS_FrequencyError(uint32_t freq_mHz, uint32_t period, uint32_t clockFreq){
+    uint64_t den = (uint64_t) clockFreq * DDS_MILLIHZ_PER_HZ;
+    uint64_t rem;
+
+    if ((den == 0) || (period == 0)){
+        return 0;
+    }
+    DDS_Divide((uint64_t) freq_mHz * period, den, &rem);
+    if (rem > den - rem){
+        rem = den - rem;                                                        // distance to the nearest tuning word, in 1/den LSB
+    }
+    return (uint32_t) (((rem * 1000000ULL) / period + (1ULL << 31)) >> 32);     // LSB * Fs / 2^32 = rem / (1000 * period * 2^32) Hz
+}
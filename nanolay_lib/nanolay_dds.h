@@ -0,0 +1,199 @@
+/* ************************************************************************** */
+// Nanolay - DDS Math Library Header File
+//
+// Description:     Direct Digital Synthesis (DDS) phase accumulator and tuning
+//                  word math used by the wave generator. Does not touch any
+//                  device register so it also compiles with a host compiler,
+//                  which allows frequency error to be checked on a PC.
+//
+// Target Device:   dsPIC33CKxxxMP202, Host
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+
+#ifndef _NANOLAY_DDS_H
+#define	_NANOLAY_DDS_H
+
+
+#include <stdint.h>
+
+
+#define DDS_MILLIHZ_PER_HZ  1000UL
+
+
+// *****************************************************************************
+// @desc:       Computes the 32bit tuning word (phase increment per sample) for
+//                  a given output frequency. One LSB of phase is 2^-32 of a
+//                  full cycle, so resolution is samplingFreq / 2^32 Hz
+// @args:       freq_mHz [uint32_t]: output frequency in mHz
+//              samplingFreq [uint32_t]: sampling frequency in Hz
+// @returns:    [uint32_t]: tuning word, rounded to nearest
+// *****************************************************************************
+uint32_t DDS_TuningWord(uint32_t freq_mHz, uint32_t samplingFreq);
+
+
+// *****************************************************************************
+// @desc:       Computes the output frequency actually produced by a tuning word
+// @args:       tuningWord [uint32_t]: phase increment per sample
+//              samplingFreq [uint32_t]: sampling frequency in Hz
+// @returns:    [uint32_t]: output frequency in mHz, rounded to nearest
+// *****************************************************************************
+uint32_t DDS_Frequency(uint32_t tuningWord, uint32_t samplingFreq);
+
+
+// *****************************************************************************
+// @desc:       Computes the tuning word for a sampling rate given as a timer
+//                  period, Fs = clockFreq / period. Exact, the sampling rate
+//                  is not rounded to whole Hz first
+// @args:       freq_mHz [uint32_t]: output frequency in mHz
+//              period [uint32_t]: timer ticks per sample
+//              clockFreq [uint32_t]: timer clock in Hz
+// @returns:    [uint32_t]: tuning word, rounded to nearest
+// *****************************************************************************
+uint32_t DDS_TuningWordPeriod(uint32_t freq_mHz, uint32_t period, uint32_t clockFreq);
+
+
+// *****************************************************************************
+// @desc:       Computes the output frequency produced by a tuning word at a
+//                  sampling rate of clockFreq / period
+// @args:       tuningWord [uint32_t]: phase increment per sample
+//              period [uint32_t]: timer ticks per sample
+//              clockFreq [uint32_t]: timer clock in Hz
+// @returns:    [uint32_t]: output frequency in mHz, rounded to nearest
+// *****************************************************************************
+uint32_t DDS_FrequencyPeriod(uint32_t tuningWord, uint32_t period, uint32_t clockFreq);
+
+
+// *****************************************************************************
+// @desc:       Computes how far the produced frequency is from the requested
+//                  one once the tuning word is rounded, at a sampling rate of
+//                  clockFreq / period. Used to pick the best sampling rate
+// @args:       freq_mHz [uint32_t]: requested output frequency in mHz
+//              period [uint32_t]: timer ticks per sample
+//              clockFreq [uint32_t]: timer clock in Hz
+// @returns:    [uint32_t]: absolute frequency error in nHz
+// *****************************************************************************
+uint32_t DDS_FrequencyError(uint32_t freq_mHz, uint32_t period, uint32_t clockFreq);
+
+
+// *****************************************************************************
+// @desc:       Maps a 32bit phase to an index of a table with tableSize
+//                  entries per cycle. Uses the upper 16 phase bits and a single
+//                  16x16 multiply so the table does not need to be a power of 2
+// @args:       phase [uint32_t]: phase accumulator value
+//              tableSize [uint16_t]: number of table entries per cycle
+// @returns:    [uint16_t]: index from 0 to tableSize - 1
+// *****************************************************************************
+static inline uint16_t DDS_TableIndex(uint32_t phase, uint16_t tableSize){
+    return (uint16_t) (((uint32_t) (uint16_t) (phase >> 16) * tableSize) >> 16);
+}
+
+
+// *****************************************************************************
+// @desc:       Multiplies a tuning word by an unsigned Q2.30 factor using only
+//                  16x16 bit multiplies, so it stays inline in an ISR. All four
+//                  partial products are kept and the 30 bits shifted out are
+//                  carried in *remainder, so a chain of products, e.g. the log
+//                  sweep growth, follows the exact value instead of falling
+//                  behind by up to 2 LSB per call
+// @args:       word [uint32_t]: tuning word
+//              q30 [uint32_t]: factor, 1.0 = 0x40000000
+//              remainder [uint32_t *]: fraction below 1 LSB, 0 to 2^30 - 1,
+//                  cleared once before the first call
+// @returns:    [uint32_t]: (word * q30 + *remainder) >> 30
+// *****************************************************************************
+static inline uint32_t DDS_MulQ30(uint32_t word, uint32_t q30, uint32_t *remainder){
+    uint16_t wh = (uint16_t) (word >> 16);
+    uint16_t wl = (uint16_t) word;
+    uint16_t qh = (uint16_t) (q30 >> 16);
+    uint16_t ql = (uint16_t) q30;
+    uint32_t hl = (uint32_t) wh * ql;
+    uint32_t lh = (uint32_t) wl * qh;
+    uint32_t ll = (uint32_t) wl * ql;
+    uint32_t mid = (hl & 0xFFFF) + (lh & 0xFFFF) + (ll >> 16);                  // product bits 16 and up, plus carries
+    uint32_t high = ((uint32_t) wh * qh) + (hl >> 16) + (lh >> 16) + (mid >> 16); // product bits 63:32
+    uint32_t low = ((mid & 0xFFFF) << 16) | (ll & 0xFFFF);                      // product bits 31:0
+    uint32_t result = (high << 2) | (low >> 30);
+    uint32_t frac = (low & 0x3FFFFFFFUL) + *remainder;
+
+    if (frac & 0x40000000UL){
+        result++;
+        frac &= 0x3FFFFFFFUL;
+    }
+    *remainder = frac;
+    return result;
+}
+
+
+// *****************************************************************************
+// @desc:       Scales a tuning word by a signed Q15 factor with two 16x16 bit
+//                  multiplies, e.g. an FM deviation by the modulating sample
+// @args:       word [uint32_t]: tuning word, below 2^31
+//              q15 [int16_t]: factor, -0x8000 = -1.0, 0x7FFF = ~1.0
+// @returns:    [int32_t]: (word * q15) >> 15
+// *****************************************************************************
+static inline int32_t DDS_MulQ15(uint32_t word, int16_t q15){
+    int16_t wh = (int16_t) (word >> 16);
+    uint16_t wl = (uint16_t) word;
+
+    return ((int32_t) wh * q15 * 2) + (((int32_t) wl * q15) >> 15);
+}
+
+
+// *****************************************************************************
+// @desc:       Looks up a sine sample from a quarter wave table. The top two
+//                  phase bits select the quadrant, which is folded onto the
+//                  table with xor masks instead of branches
+// @args:       phase [uint32_t]: phase accumulator value
+//              qTable [const int16_t *]: first quadrant, qSize + 1 entries
+//                  with qTable[qSize] holding the peak
+//              qSize [uint16_t]: table entries per quadrant
+// @returns:    [int16_t]: signed sample, -qTable[qSize] to +qTable[qSize]
+// *****************************************************************************
+static inline int16_t DDS_QuarterWave(uint32_t phase, const int16_t *qTable, uint16_t qSize){
+    uint16_t hi = (uint16_t) (phase >> 16);
+    uint16_t mirror = -((hi >> 14) & 1);                                        // 0xFFFF on 2nd and 4th quadrant
+    int16_t negate = -(int16_t) (hi >> 15);                                     // -1 on 3rd and 4th quadrant
+    uint16_t pos = (uint16_t) (((uint32_t) (uint16_t) (hi << 2) * qSize) >> 16);
+    int16_t val;
+
+    pos = (pos ^ mirror) + (mirror & (qSize + 1));                              // pos or qSize - pos
+    val = qTable[pos];
+    return (val ^ negate) - negate;                                             // val or -val
+}
+
+
+// *****************************************************************************
+// @desc:       Same as DDS_QuarterWave() but linearly interpolates between the
+//                  two nearest table entries using the next 15 phase bits as
+//                  the fraction. Costs one 16x16 multiply. Mirrored quadrants
+//                  are folded by inverting the in-quadrant phase, so the
+//                  fraction stays monotonic across the fold. The step is
+//                  rounded: truncating it pulls every value down and the sign
+//                  flip of the 3rd and 4th quadrant turns that into a half LSB
+//                  square wave, odd harmonics that cost 16dB THD at 100Hz
+// @args:       phase [uint32_t]: phase accumulator value
+//              qTable [const int16_t *]: first quadrant, qSize + 1 entries
+//              qSize [uint16_t]: table entries per quadrant
+// @returns:    [int16_t]: signed sample, -qTable[qSize] to +qTable[qSize]
+// *****************************************************************************
+static inline int16_t DDS_QuarterWaveInterp(uint32_t phase, const int16_t *qTable, uint16_t qSize){
+    uint16_t hi = (uint16_t) (phase >> 16);
+    uint16_t mirror = -((hi >> 14) & 1);                                        // 0xFFFF on 2nd and 4th quadrant
+    int16_t negate = -(int16_t) (hi >> 15);                                     // -1 on 3rd and 4th quadrant
+    uint16_t u = (uint16_t) ((hi << 2) | ((uint16_t) phase >> 14)) ^ mirror;    // in-quadrant phase, 16bit
+    uint32_t pos = (uint32_t) u * qSize;                                        // 16.16 table position
+    const int16_t *p = &qTable[(uint16_t) (pos >> 16)];
+    int16_t frac = (int16_t) ((uint16_t) pos >> 1);                             // Q15
+    int16_t val;
+
+    val = p[0] + (int16_t) (((int32_t) (p[1] - p[0]) * frac + 0x4000) >> 15);
+    return (val ^ negate) - negate;                                             // val or -val
+}
+
+
+#endif	// _NANOLAY_DDS_H
@@ -0,0 +1,243 @@
+/* ************************************************************************** */
+// Nanolay - DMA Library Source File
+//
+// Description:     Custom dsPIC33CK library for DMA functions. Should be
+//                  included in the nanolay.h file
+//
+// Target Device:   dsPIC33CKxxxMP202
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include "nanolay_dma.h"
+
+
+void (*DMA0_InterruptHandler)(bool half) = NULL;
+void (*DMA1_InterruptHandler)(bool half) = NULL;
+void (*DMA2_InterruptHandler)(bool half) = NULL;
+void (*DMA3_InterruptHandler)(bool half) = NULL;
+
+
+void DMA_Init(void){
+    DMACONbits.DMAEN = true;                                                    // enable DMA controller
+    DMACONbits.PRSSEL = 0;                                                      // fixed priority, lower channel wins
+    DMAL = 0x0000;                                                              // lower address limit, SFR space included
+    DMAH = 0x7FFF;                                                              // upper address limit, end of near data RAM
+}
+
+
+void DMA_ChannelInit(DMA_Channel ch, DMA_Trigger trigger, volatile void *src, DMA_AddrMode srcMode, volatile void *dst, DMA_AddrMode dstMode, uint_fast16_t count, DMA_TransferMode mode){
+    DMA_Init();
+
+    switch ( ch ){
+        case DMA_CH0:
+            PMD7bits.DMA0MD = 0;                                                // enable DMA0 peripheral
+            DMACH0 = 0x0000;                                                    // make sure channel is disabled at initialization
+            DMAINT0 = 0x0000;                                                   // clear all flags, no half block interrupt
+            DMACH0bits.SIZE = 0;                                                // word transfers
+            DMACH0bits.RELOAD = 1;                                              // reload address and count after each block
+            DMACH0bits.TRMODE = mode;
+            DMACH0bits.SAMODE = srcMode;
+            DMACH0bits.DAMODE = dstMode;
+            DMAINT0bits.CHSEL = trigger;
+            DMASRC0 = (uint_fast16_t) src;
+            DMADST0 = (uint_fast16_t) dst;
+            DMACNT0 = count;
+            IEC0bits.DMA0IE = false;
+            break;
+        case DMA_CH1:
+            PMD7bits.DMA1MD = 0;                                                // enable DMA1 peripheral
+            DMACH1 = 0x0000;                                                    // make sure channel is disabled at initialization
+            DMAINT1 = 0x0000;                                                   // clear all flags, no half block interrupt
+            DMACH1bits.SIZE = 0;                                                // word transfers
+            DMACH1bits.RELOAD = 1;                                              // reload address and count after each block
+            DMACH1bits.TRMODE = mode;
+            DMACH1bits.SAMODE = srcMode;
+            DMACH1bits.DAMODE = dstMode;
+            DMAINT1bits.CHSEL = trigger;
+            DMASRC1 = (uint_fast16_t) src;
+            DMADST1 = (uint_fast16_t) dst;
+            DMACNT1 = count;
+            IEC0bits.DMA1IE = false;
+            break;
+        case DMA_CH2:
+            PMD7bits.DMA2MD = 0;                                                // enable DMA2 peripheral
+            DMACH2 = 0x0000;                                                    // make sure channel is disabled at initialization
+            DMAINT2 = 0x0000;                                                   // clear all flags, no half block interrupt
+            DMACH2bits.SIZE = 0;                                                // word transfers
+            DMACH2bits.RELOAD = 1;                                              // reload address and count after each block
+            DMACH2bits.TRMODE = mode;
+            DMACH2bits.SAMODE = srcMode;
+            DMACH2bits.DAMODE = dstMode;
+            DMAINT2bits.CHSEL = trigger;
+            DMASRC2 = (uint_fast16_t) src;
+            DMADST2 = (uint_fast16_t) dst;
+            DMACNT2 = count;
+            IEC1bits.DMA2IE = false;
+            break;
+        case DMA_CH3:
+            PMD7bits.DMA3MD = 0;                                                // enable DMA3 peripheral
+            DMACH3 = 0x0000;                                                    // make sure channel is disabled at initialization
+            DMAINT3 = 0x0000;                                                   // clear all flags, no half block interrupt
+            DMACH3bits.SIZE = 0;                                                // word transfers
+            DMACH3bits.RELOAD = 1;                                              // reload address and count after each block
+            DMACH3bits.TRMODE = mode;
+            DMACH3bits.SAMODE = srcMode;
+            DMACH3bits.DAMODE = dstMode;
+            DMAINT3bits.CHSEL = trigger;
+            DMASRC3 = (uint_fast16_t) src;
+            DMADST3 = (uint_fast16_t) dst;
+            DMACNT3 = count;
+            IEC1bits.DMA3IE = false;
+            break;
+    }
+}
+
+
+void DMA_SetInterrupt(DMA_Channel ch, bool halfEn, void (* InterruptHandler)(bool half), uint_fast8_t priority){
+    switch ( ch ){
+        case DMA_CH0:
+            IPC1bits.DMA0IP = priority;
+            DMA0_InterruptHandler = InterruptHandler;
+            DMAINT0bits.HALFEN = halfEn;
+            DMAINT0bits.HALFIF = false;
+            DMAINT0bits.DONEIF = false;
+            IFS0bits.DMA0IF = false;
+            IEC0bits.DMA0IE = true;
+            break;
+        case DMA_CH1:
+            IPC1bits.DMA1IP = priority;
+            DMA1_InterruptHandler = InterruptHandler;
+            DMAINT1bits.HALFEN = halfEn;
+            DMAINT1bits.HALFIF = false;
+            DMAINT1bits.DONEIF = false;
+            IFS0bits.DMA1IF = false;
+            IEC0bits.DMA1IE = true;
+            break;
+        case DMA_CH2:
+            IPC6bits.DMA2IP = priority;
+            DMA2_InterruptHandler = InterruptHandler;
+            DMAINT2bits.HALFEN = halfEn;
+            DMAINT2bits.HALFIF = false;
+            DMAINT2bits.DONEIF = false;
+            IFS1bits.DMA2IF = false;
+            IEC1bits.DMA2IE = true;
+            break;
+        case DMA_CH3:
+            IPC6bits.DMA3IP = priority;
+            DMA3_InterruptHandler = InterruptHandler;
+            DMAINT3bits.HALFEN = halfEn;
+            DMAINT3bits.HALFIF = false;
+            DMAINT3bits.DONEIF = false;
+            IFS1bits.DMA3IF = false;
+            IEC1bits.DMA3IE = true;
+            break;
+    }
+}
+
+
+void DMA_Start(DMA_Channel ch){
+    switch ( ch ){
+        case DMA_CH0:
+            DMACH0bits.CHEN = true;
+            break;
+        case DMA_CH1:
+            DMACH1bits.CHEN = true;
+            break;
+        case DMA_CH2:
+            DMACH2bits.CHEN = true;
+            break;
+        case DMA_CH3:
+            DMACH3bits.CHEN = true;
+            break;
+    }
+}
+
+
+void DMA_Stop(DMA_Channel ch){
+    switch ( ch ){
+        case DMA_CH0:
+            DMACH0bits.CHEN = false;
+            DMAINT0bits.HALFIF = false;                                         // drop pending events, the interrupt enable is kept
+            DMAINT0bits.DONEIF = false;
+            IFS0bits.DMA0IF = false;
+            break;
+        case DMA_CH1:
+            DMACH1bits.CHEN = false;
+            DMAINT1bits.HALFIF = false;                                         // drop pending events, the interrupt enable is kept
+            DMAINT1bits.DONEIF = false;
+            IFS0bits.DMA1IF = false;
+            break;
+        case DMA_CH2:
+            DMACH2bits.CHEN = false;
+            DMAINT2bits.HALFIF = false;                                         // drop pending events, the interrupt enable is kept
+            DMAINT2bits.DONEIF = false;
+            IFS1bits.DMA2IF = false;
+            break;
+        case DMA_CH3:
+            DMACH3bits.CHEN = false;
+            DMAINT3bits.HALFIF = false;                                         // drop pending events, the interrupt enable is kept
+            DMAINT3bits.DONEIF = false;
+            IFS1bits.DMA3IF = false;
+            break;
+    }
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _DMA0Interrupt (void){
+    IFS0bits.DMA0IF = false;
+
+    if ( DMAINT0bits.HALFIF ){
+        DMAINT0bits.HALFIF = false;
+        DMA0_InterruptHandler(true);
+    }
+    if ( DMAINT0bits.DONEIF ){
+        DMAINT0bits.DONEIF = false;
+        DMA0_InterruptHandler(false);
+    }
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _DMA1Interrupt (void){
+    IFS0bits.DMA1IF = false;
+
+    if ( DMAINT1bits.HALFIF ){
+        DMAINT1bits.HALFIF = false;
+        DMA1_InterruptHandler(true);
+    }
+    if ( DMAINT1bits.DONEIF ){
+        DMAINT1bits.DONEIF = false;
+        DMA1_InterruptHandler(false);
+    }
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _DMA2Interrupt (void){
+    IFS1bits.DMA2IF = false;
+
+    if ( DMAINT2bits.HALFIF ){
+        DMAINT2bits.HALFIF = false;
+        DMA2_InterruptHandler(true);
+    }
+    if ( DMAINT2bits.DONEIF ){
+        DMAINT2bits.DONEIF = false;
+        DMA2_InterruptHandler(false);
+    }
+}
+
+
+void __attribute__ ((interrupt, no_auto_psv)) _DMA3Interrupt (void){
+    IFS1bits.DMA3IF = false;
+
+    if ( DMAINT3bits.HALFIF ){
+        DMAINT3bits.HALFIF = false;
+        DMA3_InterruptHandler(true);
+    }
+    if ( DMAINT3bits.DONEIF ){
+        DMAINT3bits.DONEIF = false;
+        DMA3_InterruptHandler(false);
+    }
+}
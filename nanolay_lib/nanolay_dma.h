@@ -0,0 +1,111 @@
+/* ************************************************************************** */
+// Nanolay - DMA Library Header File
+//
+// Description:     Custom dsPIC33CK library for DMA functions. Should be
+//                  included in the nanolay.h file
+//
+// Target Device:   dsPIC33CKxxxMP202
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#ifndef _NANOLAY_DMA_H
+#define	_NANOLAY_DMA_H
+
+
+#include "nanolay.h"
+
+
+// Trigger source select values (DMAINTx.CHSEL), refer to the DMA channel
+// trigger sources table of the device datasheet
+typedef enum dma_trigger {
+    DMA_TRIG_SCCP7_CCP = 0x0D,                                                  // SCCP7 compare event, ADC stream
+    DMA_TRIG_SCCP8_TMR = 0x10,                                                  // SCCP8 timer period match
+} DMA_Trigger;
+
+
+typedef enum dma_channel {
+    DMA_CH0 = 0,
+    DMA_CH1 = 1,
+    DMA_CH2 = 2,
+    DMA_CH3 = 3
+} DMA_Channel;
+
+
+typedef enum dma_addr_mode {
+    DMA_ADDR_FIXED = 0,
+    DMA_ADDR_INC = 1,
+    DMA_ADDR_DEC = 2
+} DMA_AddrMode;
+
+
+typedef enum dma_transfer_mode {
+    DMA_ONESHOT = 0,                                                            // one word per trigger, stops after count
+    DMA_REPEATED_ONESHOT = 1,                                                   // one word per trigger, reloads after count
+    DMA_CONTINUOUS = 2,                                                         // whole block per trigger, stops after count
+    DMA_REPEATED_CONTINUOUS = 3                                                 // whole block per trigger, reloads after count
+} DMA_TransferMode;
+
+
+// *****************************************************************************
+// @desc:       Enables the DMA controller and opens the address window to all
+//                  SFR and data RAM. Called by DMA_ChannelInit()
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void DMA_Init(void);
+
+
+// *****************************************************************************
+// @desc:       Configure a DMA channel for 16bit word transfers. Source and
+//                  destination addresses and count are reloaded at the end of
+//                  each block so repeated modes loop over the same buffer
+// @args:       ch [DMA_Channel]: DMA_CHx
+//              trigger [DMA_Trigger]: peripheral event that starts a transfer
+//              src [volatile void *]: source address in data memory
+//              srcMode [DMA_AddrMode]: source address update after a transfer
+//              dst [volatile void *]: destination address in data memory
+//              dstMode [DMA_AddrMode]: destination address update
+//              count [uint_fast16_t]: number of words per block
+//              mode [DMA_TransferMode]: transfer mode
+// @returns:    None
+// *****************************************************************************
+void DMA_ChannelInit(DMA_Channel ch, DMA_Trigger trigger, volatile void *src, DMA_AddrMode srcMode, volatile void *dst, DMA_AddrMode dstMode, uint_fast16_t count, DMA_TransferMode mode);
+
+
+// *****************************************************************************
+// @desc:       Assigns a user defined function as interrupt callback routine.
+//                  Callback is called at block completion and, if halfEn is
+//                  set, also when half of the block has been transferred
+// @args:       ch [DMA_Channel]: DMA_CHx
+//              halfEn [bool]: true = also interrupt at half block
+//              InterruptHandler [func pointer]: User defined ISR, called with
+//                  true at half block and false at block completion
+//              priority [uint_fast8_t]: priority level from 1-7
+// @returns:    None
+// *****************************************************************************
+void DMA_SetInterrupt(DMA_Channel ch, bool halfEn, void (* InterruptHandler)(bool half), uint_fast8_t priority);
+
+
+// *****************************************************************************
+// @desc:       Enable DMA channel. Transfers start on the next trigger
+// @args:       ch [DMA_Channel]: DMA_CHx
+// @returns:    None
+// *****************************************************************************
+void DMA_Start(DMA_Channel ch);
+
+
+// *****************************************************************************
+// @desc:       Disable DMA channel and clear its pending flags. The interrupt
+//                  set up by DMA_SetInterrupt() stays enabled, so the handler
+//                  runs again after DMA_Start()
+// @args:       ch [DMA_Channel]: DMA_CHx
+// @returns:    None
+// *****************************************************************************
+void DMA_Stop(DMA_Channel ch);
+
+
+#endif	// _NANOLAY_DMA_H
@@ -0,0 +1,395 @@
+/* ************************************************************************** */
+// Nanolay - DSP Library Source File
+//
+// Description:     Block analyzers and filters for sampled signals: a multi
+//                  bin Goertzel tone detector, a radix-2 Q15 FFT, Q15 FIR
+//                  filters and biquad IIR cascades. The only register used is
+//                  CORCON, set for the MAC unit on entry and restored on
+//                  return, so it also compiles with a host compiler.
+//
+// Target Device:   dsPIC33CKxxxMP202, Host
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include <stddef.h>
+#if defined(__XC16__)
+#include <xc.h>
+#endif
+#include "nanolay_dds.h"
+#include "nanolay_dsp.h"
+
+
+#define DSP_QSIZE   (DSP_FFT_MAX_POINTS / 4)
+
+
+// sin(2 * pi * k / DSP_FFT_MAX_POINTS) in Q15 for the first quadrant
+static const int16_t sineQ15[DSP_QSIZE + 1] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602, 6393, 7179,
+    7962, 8739, 9512, 10278, 11039, 11793, 12539, 13279, 14010, 14732,
+    15446, 16151, 16846, 17530, 18204, 18868, 19519, 20159, 20787, 21403,
+    22005, 22594, 23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956, 30273, 30571,
+    30852, 31113, 31356, 31580, 31785, 31971, 32137, 32285, 32412, 32521,
+    32609, 32678, 32728, 32757, 32767
+};
+
+
+static DSP_Complex twiddle[DSP_FFT_MAX_POINTS / 2];                             // cos and -sin of 2 * pi * k / DSP_FFT_MAX_POINTS
+
+
+static inline int16_t DSP_Sat16(int32_t val){
+    if (val > 32767){
+        return 32767;
+    }
+    else if (val < -32768){
+        return -32768;
+    }
+    return (int16_t) val;
+}
+
+
+// (s * c) >> 14 for a 32bit state and a Q14 coefficient with two 16x16 bit
+// multiplies. The low half product fits 32bit since it is at most 65535 * 32768
+static inline int32_t DSP_MulQ14(int32_t s, int16_t c){
+    int16_t sh = (int16_t) (s >> 16);
+    uint16_t sl = (uint16_t) s;
+
+    return ((int32_t) sh * c * 4) + (((int32_t) sl * c) >> 14);
+}
+
+
+// Sets the MAC unit mode the host emulation implements: signed fractional
+// multiply, wrapping accumulator and saturating store. Returns the caller's
+// CORCON for DSP_ModeExit()
+static inline uint16_t DSP_ModeEnter(void){
+#if defined(__XC16__)
+    uint16_t corcon = CORCON;
+
+    CORCONbits.US = 0;
+    CORCONbits.SATA = 0;
+    CORCONbits.SATDW = 1;
+    CORCONbits.IF = 0;
+    return corcon;
+#else
+    return 0;
+#endif
+}
+
+
+static inline void DSP_ModeExit(uint16_t corcon){
+#if defined(__XC16__)
+    CORCON = corcon;
+#else
+    (void) corcon;
+#endif
+}
+
+
+static uint32_t DSP_Sqrt(uint64_t val){
+    uint64_t bit = (uint64_t) 1 << 62;
+    uint64_t root = 0;
+
+    while (bit > val){
+        bit >>= 2;
+    }
+    while (bit != 0){                                                           // one result bit per pass
+        if (val >= root + bit){
+            val -= root + bit;
+            root = (root >> 1) + bit;
+        }
+        else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t) root;
+}
+
+
+bool DSP_GoertzelInit(DSP_Goertzel *g, const uint32_t *freq_mHz, uint_fast8_t bins, uint32_t samplingFreq, uint_fast16_t length){
+    uint_fast8_t i;
+    uint32_t word;
+    int32_t sine, cosine;
+
+    if ((bins == 0) || (bins > DSP_GOERTZEL_MAX_BINS) || (length == 0) || (length > DSP_GOERTZEL_MAX_LENGTH)){
+        return false;
+    }
+    g->bins = bins;
+    g->length = length;
+    g->count = 0;
+    for (i = 0; i < bins; i++){
+        // 2cos(w) in Q14 is cos(w) in Q15. Below 3/32 of Fs it is taken as
+        // 1 - 2sin(w/2)^2 since the table is nearly straight there; at the
+        // cosine peak the interpolation error alone moved a 1kHz bin by 30Hz
+        // at 100kHz
+        word = DDS_TuningWord(freq_mHz[i], samplingFreq);
+        if (word < 0x18000000UL){
+            sine = DDS_QuarterWaveInterp(word >> 1, sineQ15, DSP_QSIZE);
+            cosine = 32768 - ((sine * sine + 8192) >> 14);
+        }
+        else {
+            cosine = DDS_QuarterWaveInterp(word + 0x40000000UL, sineQ15, DSP_QSIZE);
+        }
+        g->coeff[i] = (cosine > 32767) ? 32767 : (int16_t) cosine;
+        g->s1[i] = 0;
+        g->s2[i] = 0;
+        g->amplitude[i] = 0;
+    }
+    return true;
+}
+
+
+bool DSP_GoertzelBlock(DSP_Goertzel *g, const uint16_t *samples, uint_fast16_t count){
+    const uint16_t *x;
+    uint_fast16_t chunk, n;
+    uint_fast8_t i;
+    int32_t s0, s1, s2;
+    int16_t c;
+    int64_t power;
+    uint32_t amplitude;
+    bool ready = false;
+
+    while (count != 0){
+        chunk = g->length - g->count;
+        if (chunk > count){
+            chunk = count;
+        }
+        for (i = 0; i < g->bins; i++){                                          // bins outer, the state stays in registers
+            s1 = g->s1[i];
+            s2 = g->s2[i];
+            c = g->coeff[i];
+            x = samples;
+            for (n = chunk; n != 0; n--){
+                s0 = ((int32_t) *x++ - DSP_ADC_MIDSCALE) + DSP_MulQ14(s1, c) - s2;
+                s2 = s1;
+                s1 = s0;
+            }
+            g->s1[i] = s1;
+            g->s2[i] = s2;
+        }
+        samples += chunk;
+        count -= chunk;
+        g->count += chunk;
+
+        if (g->count == g->length){                                             // |X|^2 = s1^2 + s2^2 - 2cos(w) s1 s2
+            for (i = 0; i < g->bins; i++){
+                s1 = g->s1[i];
+                s2 = g->s2[i];
+                power = ((int64_t) s1 * s1) + ((int64_t) s2 * s2) - ((int64_t) s1 * ((int64_t) s2 * g->coeff[i] >> 14)); // s1 * s2 * coeff would pass 2^63 near DC
+                amplitude = (2 * DSP_Sqrt((power > 0) ? (uint64_t) power : 0)) / g->length;
+                g->amplitude[i] = (amplitude > 0xFFFF) ? 0xFFFF : amplitude;
+                g->s1[i] = 0;
+                g->s2[i] = 0;
+            }
+            g->count = 0;
+            ready = true;
+        }
+    }
+    return ready;
+}
+
+
+void DSP_FFTInit(void){
+    uint_fast16_t k;
+
+    for (k = 0; k < DSP_FFT_MAX_POINTS / 2; k++){
+        if (k <= DSP_QSIZE){
+            twiddle[k].re = sineQ15[DSP_QSIZE - k];
+            twiddle[k].im = -sineQ15[k];
+        }
+        else {
+            twiddle[k].re = -sineQ15[k - DSP_QSIZE];
+            twiddle[k].im = -sineQ15[2 * DSP_QSIZE - k];
+        }
+    }
+}
+
+
+void DSP_FFTLoad(DSP_Complex *data, const uint16_t *samples, uint_fast16_t points){
+    while (points--){
+        data->re = (int16_t) (((int16_t) *samples++ - DSP_ADC_MIDSCALE) * 8);   // 12bit to Q15
+        data->im = 0;
+        data++;
+    }
+}
+
+
+bool DSP_FFT(DSP_Complex *data, uint_fast16_t points){
+    uint16_t mode;
+    DSP_ACC_DECL(acc);
+    DSP_Complex *a, *b, w, t;
+    uint_fast16_t i, j, k, bit, span, stride;
+    int16_t tre, tim, are, aim;
+
+    if ((points < 2) || (points > DSP_FFT_MAX_POINTS) || (points & (points - 1))){ // the twiddle stride only fits powers of 2
+        return false;
+    }
+    for (i = 1, j = 0; i < points; i++){                                        // bit reversed reorder
+        for (bit = points >> 1; j & bit; bit >>= 1){
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j){
+            t = data[i];
+            data[i] = data[j];
+            data[j] = t;
+        }
+    }
+
+    mode = DSP_ModeEnter();
+    for (span = 1, stride = DSP_FFT_MAX_POINTS / 2; span < points; span <<= 1, stride >>= 1){
+        for (k = 0; k < span; k++){
+            w = twiddle[k * stride];
+            for (i = k; i < points; i += 2 * span){
+                a = &data[i];
+                b = &data[i + span];
+
+                DSP_CLR(acc);                                                   // t = b * w / 2
+                DSP_MAC(acc, b->re, w.re);
+                DSP_MSC(acc, b->im, w.im);
+                tre = DSP_SAC(acc, 1);
+                DSP_CLR(acc);
+                DSP_MAC(acc, b->re, w.im);
+                DSP_MAC(acc, b->im, w.re);
+                tim = DSP_SAC(acc, 1);
+
+                are = a->re >> 1;
+                aim = a->im >> 1;
+                a->re = DSP_Sat16((int32_t) are + tre);
+                a->im = DSP_Sat16((int32_t) aim + tim);
+                b->re = DSP_Sat16((int32_t) are - tre);
+                b->im = DSP_Sat16((int32_t) aim - tim);
+            }
+        }
+    }
+    DSP_ModeExit(mode);
+    return true;
+}
+
+
+void DSP_FFTPower(const DSP_Complex *data, uint32_t *power, uint_fast16_t bins){
+    while (bins--){
+        *power++ = (uint32_t) ((int32_t) data->re * data->re) + (uint32_t) ((int32_t) data->im * data->im);
+        data++;
+    }
+}
+
+
+void DSP_FromADC(int16_t *out, const uint16_t *samples, uint_fast16_t count){
+    while (count--){
+        *out++ = (int16_t) (((int16_t) *samples++ - DSP_ADC_MIDSCALE) * 8);
+    }
+}
+
+
+void DSP_ToDAC(uint16_t *out, const int16_t *in, uint_fast16_t count){
+    while (count--){
+        *out++ = (uint16_t) ((*in++ >> 4) + DSP_ADC_MIDSCALE);
+    }
+}
+
+
+void DSP_FIRInit(DSP_FIR *f, const int16_t *coeff, int16_t *delay, uint_fast16_t taps){
+    uint_fast16_t i;
+
+    f->coeff = coeff;
+    f->delay = delay;
+    f->taps = taps;
+    f->index = 0;
+    for (i = 0; i < 2 * taps; i++){
+        delay[i] = 0;
+    }
+}
+
+
+void DSP_FIRBlock(DSP_FIR *f, const int16_t *in, int16_t *out, uint_fast16_t count){
+    uint16_t mode;
+    DSP_ACC_DECL(acc);
+    const int16_t *h, *x;
+    uint_fast16_t taps = f->taps;
+    uint_fast16_t index = f->index;
+    uint_fast16_t k;
+
+    mode = DSP_ModeEnter();
+    while (count--){
+        index = (index == 0) ? (taps - 1) : (index - 1);                        // one wrap test per sample, not per tap
+        f->delay[index] = *in;
+        f->delay[index + taps] = *in++;
+
+        h = f->coeff;
+        x = &f->delay[index];                                                   // x[n - k] = x[k], k = 0 to taps - 1
+        DSP_CLR(acc);
+        for (k = taps; k != 0; k--){
+            DSP_MAC(acc, *h++, *x++);
+        }
+        *out++ = DSP_SAC(acc, 0);
+    }
+    f->index = index;
+    DSP_ModeExit(mode);
+}
+
+
+void DSP_IIRInit(DSP_IIR *f, const DSP_BiquadCoeff *coeff, DSP_BiquadState *state, uint_fast8_t sections){
+    uint_fast8_t i;
+
+    f->coeff = coeff;
+    f->state = state;
+    f->sections = sections;
+    for (i = 0; i < sections; i++){
+        state[i].x1 = 0;
+        state[i].x2 = 0;
+        state[i].y1 = 0;
+        state[i].y2 = 0;
+    }
+}
+
+
+void DSP_IIRBlock(DSP_IIR *f, const int16_t *in, int16_t *out, uint_fast16_t count){
+    uint16_t mode;
+    DSP_ACC_DECL(acc);
+    const DSP_BiquadCoeff *c;
+    DSP_BiquadState *st;
+    const int16_t *src;
+    int16_t *dst;
+    int16_t x0, x1, x2, y0, y1, y2;
+    uint_fast16_t n;
+    uint_fast8_t i;
+
+    mode = DSP_ModeEnter();
+    for (i = 0; i < f->sections; i++){
+        c = &f->coeff[i];
+        st = &f->state[i];
+        x1 = st->x1;
+        x2 = st->x2;
+        y1 = st->y1;
+        y2 = st->y2;
+        src = (i == 0) ? in : out;                                              // later sections filter out in place
+        dst = out;
+
+        for (n = count; n != 0; n--){
+            x0 = *src++;
+            DSP_CLR(acc);
+            DSP_MAC(acc, c->b0, x0);
+            DSP_MAC(acc, c->b1, x1);
+            DSP_MAC(acc, c->b2, x2);
+            DSP_MSC(acc, c->a1, y1);
+            DSP_MSC(acc, c->a2, y2);
+            y0 = DSP_SAC(acc, -1);                                              // Q14 coefficients, shift back to Q15
+            *dst++ = y0;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+        }
+
+        st->x1 = x1;
+        st->x2 = x2;
+        st->y1 = y1;
+        st->y2 = y2;
+    }
+    DSP_ModeExit(mode);
+}
@@ -0,0 +1,273 @@
+/* ************************************************************************** */
+// Nanolay - DSP Library Header File
+//
+// Description:     Block analyzers and filters for sampled signals: a multi
+//                  bin Goertzel tone detector, a radix-2 Q15 FFT, Q15 FIR
+//                  filters and biquad IIR cascades. This is a scalar
+//                  implementation: the MAC builtins are used without X/Y
+//                  prefetch, so each operand is a separate load, and the
+//                  Goertzel recursion is plain C. The only register used is
+//                  CORCON, set for the MAC unit on entry and restored on
+//                  return, so it also compiles with a host compiler. On the host
+//                  the DSP engine is emulated with the same fractional
+//                  multiply, 40bit accumulate and saturating store, so results
+//                  are bit identical to the device.
+//
+// Target Device:   dsPIC33CKxxxMP202, Host
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+
+#ifndef _NANOLAY_DSP_H
+#define	_NANOLAY_DSP_H
+
+
+#include <stdint.h>
+#include <stdbool.h>
+
+
+#define DSP_FFT_MAX_POINTS      256
+#define DSP_GOERTZEL_MAX_BINS   8
+#define DSP_GOERTZEL_MAX_LENGTH 4096                                            // longest block the 32bit state holds at full scale
+#define DSP_ADC_MIDSCALE        2048                                            // 12bit unsigned ADC samples are centered here
+
+
+#if defined(__XC16__)
+#define DSP_ACC_DECL(a)     register int a asm("A")
+#define DSP_CLR(a)          a = __builtin_clr()
+#define DSP_MAC(a, x, y)    a = __builtin_mac(a, x, y, NULL, NULL, 0, NULL, NULL, 0, NULL, 0)
+#define DSP_MSC(a, x, y)    a = __builtin_msc(a, x, y, NULL, NULL, 0, NULL, NULL, 0, NULL, 0)
+#define DSP_SAC(a, shift)   __builtin_sac(a, shift)                             // truncating store, saturated by CORCON.SATDW
+#else
+#define DSP_ACC_DECL(a)     int64_t a
+#define DSP_CLR(a)          a = 0
+#define DSP_MAC(a, x, y)    a += ((int64_t) (x) * (y)) * 2                      // fractional mode, product shifted left once
+#define DSP_MSC(a, x, y)    a -= ((int64_t) (x) * (y)) * 2
+#define DSP_SAC(a, shift)   DSP_Sac(a, shift)
+#endif
+
+
+typedef struct dsp_complex {
+    int16_t     re;
+    int16_t     im;
+} DSP_Complex;
+
+
+typedef struct dsp_fir {
+    const int16_t       *coeff;                                                 // Q15 taps, h[0] first
+    int16_t             *delay;                                                 // 2 * taps samples, every sample is stored twice
+    uint_fast16_t       taps;
+    uint_fast16_t       index;                                                  // position of the newest sample
+} DSP_FIR;
+
+
+typedef struct dsp_biquad_coeff {
+    int16_t             b0;                                                     // all Q14, -2.0 to ~2.0
+    int16_t             b1;
+    int16_t             b2;
+    int16_t             a1;                                                     // y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2
+    int16_t             a2;
+} DSP_BiquadCoeff;
+
+
+typedef struct dsp_biquad_state {
+    int16_t             x1;
+    int16_t             x2;
+    int16_t             y1;
+    int16_t             y2;
+} DSP_BiquadState;
+
+
+typedef struct dsp_iir {
+    const DSP_BiquadCoeff   *coeff;
+    DSP_BiquadState         *state;
+    uint_fast8_t            sections;
+} DSP_IIR;
+
+
+typedef struct dsp_goertzel {
+    uint_fast8_t        bins;
+    uint_fast16_t       length;                                                 // samples per result
+    uint_fast16_t       count;                                                  // samples of the current result so far
+    int16_t             coeff[DSP_GOERTZEL_MAX_BINS];                           // 2cos(w) in Q14
+    int32_t             s1[DSP_GOERTZEL_MAX_BINS];
+    int32_t             s2[DSP_GOERTZEL_MAX_BINS];
+    uint16_t            amplitude[DSP_GOERTZEL_MAX_BINS];                       // last result, peak amplitude in ADC LSB
+} DSP_Goertzel;
+
+
+// *****************************************************************************
+// @desc:       Saturating accumulator store as done by the dsPIC, used by
+//                  DSP_SAC() on the host
+// @args:       acc [int64_t]: 40bit accumulator value
+//              shift [int]: right shift applied before the store, -8 to 7
+// @returns:    [int16_t]: accumulator bits 31:16, saturated
+// *****************************************************************************
+static inline int16_t DSP_Sac(int64_t acc, int shift){
+    int64_t v = (shift >= 0) ? (acc >> shift) : (acc * ((int64_t) 1 << -shift));
+
+    if (v > 0x7FFFFFFFLL){
+        return 0x7FFF;
+    }
+    else if (v < -0x80000000LL){
+        return (int16_t) 0x8000;
+    }
+    return (int16_t) (v >> 16);
+}
+
+
+// *****************************************************************************
+// @desc:       Initialize a Goertzel detector for up to DSP_GOERTZEL_MAX_BINS
+//                  frequencies. Each result covers length samples. The tone
+//                  frequency does not have to be a multiple of
+//                  samplingFreq / length. The Q14 coefficient cannot resolve
+//                  frequencies below about samplingFreq / 800
+// @args:       g [DSP_Goertzel *]: detector state
+//              freq_mHz [const uint32_t *]: frequency of each bin in mHz
+//              bins [uint_fast8_t]: number of bins, 1 to DSP_GOERTZEL_MAX_BINS
+//              samplingFreq [uint32_t]: sampling frequency in Hz
+//              length [uint_fast16_t]: samples per result, 1 to
+//                  DSP_GOERTZEL_MAX_LENGTH
+// @returns:    [bool]: false = bins or length out of range, g left unchanged
+// *****************************************************************************
+bool DSP_GoertzelInit(DSP_Goertzel *g, const uint32_t *freq_mHz, uint_fast8_t bins, uint32_t samplingFreq, uint_fast16_t length);
+
+
+// *****************************************************************************
+// @desc:       Runs a block of 12bit ADC samples through all bins, e.g. a
+//                  block handed over by the ADC stream. Blocks do not have to
+//                  line up with length. The state is kept in 32bit, a Q15
+//                  state would overflow after a few dozen samples near DC
+// @args:       g [DSP_Goertzel *]: detector state
+//              samples [const uint16_t *]: unsigned samples
+//              count [uint_fast16_t]: number of samples
+// @returns:    [bool]: true = g->amplitude holds a new result
+// *****************************************************************************
+bool DSP_GoertzelBlock(DSP_Goertzel *g, const uint16_t *samples, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Fills the twiddle table. Must be called once
+//                  before DSP_FFT()
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void DSP_FFTInit(void);
+
+
+// *****************************************************************************
+// @desc:       Converts a block of 12bit ADC samples into FFT input: midscale
+//                  removed, scaled to Q15, imaginary part zero
+// @args:       data [DSP_Complex *]: FFT buffer
+//              samples [const uint16_t *]: unsigned samples
+//              points [uint_fast16_t]: number of samples
+// @returns:    None
+// *****************************************************************************
+void DSP_FFTLoad(DSP_Complex *data, const uint16_t *samples, uint_fast16_t points);
+
+
+// *****************************************************************************
+// @desc:       In place radix-2 decimation in time FFT. Each stage is scaled by
+//                  1/2, so the output is the DFT / points. Twiddle products
+//                  are summed in the MAC unit and saturated once. Scalar
+//                  butterflies, (points / 2) * log2(points) of them
+// @args:       data [DSP_Complex *]: input in natural order, output in natural
+//                  order
+//              points [uint_fast16_t]: power of 2, 2 to DSP_FFT_MAX_POINTS
+// @returns:    [bool]: false = points not a power of 2 or out of range, data
+//                  left unchanged
+// *****************************************************************************
+bool DSP_FFT(DSP_Complex *data, uint_fast16_t points);
+
+
+// *****************************************************************************
+// @desc:       Squared magnitude of FFT bins
+// @args:       data [const DSP_Complex *]: DSP_FFT() output
+//              power [uint32_t *]: re^2 + im^2 per bin, Q30
+//              bins [uint_fast16_t]: number of bins, points / 2 for real input
+// @returns:    None
+// *****************************************************************************
+void DSP_FFTPower(const DSP_Complex *data, uint32_t *power, uint_fast16_t bins);
+
+
+
+// *****************************************************************************
+// @desc:       Converts 12bit ADC samples to Q15 with midscale removed, the
+//                  input format of the filters
+// @args:       out [int16_t *]: Q15 samples
+//              samples [const uint16_t *]: unsigned samples
+//              count [uint_fast16_t]: number of samples
+// @returns:    None
+// *****************************************************************************
+void DSP_FromADC(int16_t *out, const uint16_t *samples, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Converts Q15 samples to 12bit DAC values around DAC midscale,
+//                  e.g. to filter a block before it is queued to the DAC
+// @args:       out [uint16_t *]: DAC values, clamped by the DAC driver
+//              in [const int16_t *]: Q15 samples
+//              count [uint_fast16_t]: number of samples
+// @returns:    None
+// *****************************************************************************
+void DSP_ToDAC(uint16_t *out, const int16_t *in, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Initialize a Q15 FIR filter. The delay line keeps every sample
+//                  twice, taps apart, so the newest taps samples are always
+//                  contiguous and the MAC loop runs without any wraparound
+//                  test. Costs one extra store per sample instead of one
+//                  index check per tap
+// @args:       f [DSP_FIR *]: filter state
+//              coeff [const int16_t *]: Q15 taps, h[0] first
+//              delay [int16_t *]: 2 * taps words of data RAM, cleared here
+//              taps [uint_fast16_t]: number of taps
+// @returns:    None
+// *****************************************************************************
+void DSP_FIRInit(DSP_FIR *f, const int16_t *coeff, int16_t *delay, uint_fast16_t taps);
+
+
+// *****************************************************************************
+// @desc:       Filters a block. Sums are kept in the 40bit accumulator and
+//                  saturated once per output sample
+// @args:       f [DSP_FIR *]: filter state
+//              in [const int16_t *]: Q15 samples
+//              out [int16_t *]: Q15 samples, may be the same buffer as in
+//              count [uint_fast16_t]: number of samples
+// @returns:    None
+// *****************************************************************************
+void DSP_FIRBlock(DSP_FIR *f, const int16_t *in, int16_t *out, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Initialize a cascade of direct form I biquads and clear their
+//                  state
+// @args:       f [DSP_IIR *]: filter
+//              coeff [const DSP_BiquadCoeff *]: one set per section, Q14
+//              state [DSP_BiquadState *]: one per section
+//              sections [uint_fast8_t]: number of sections
+// @returns:    None
+// *****************************************************************************
+void DSP_IIRInit(DSP_IIR *f, const DSP_BiquadCoeff *coeff, DSP_BiquadState *state, uint_fast8_t sections);
+
+
+// *****************************************************************************
+// @desc:       Filters a block through all sections, one section at a time
+//                  over the whole block so its state stays in registers. Each
+//                  output is summed in the 40bit accumulator, so only the
+//                  section output is saturated
+// @args:       f [DSP_IIR *]: filter
+//              in [const int16_t *]: Q15 samples
+//              out [int16_t *]: Q15 samples, may be the same buffer as in
+//              count [uint_fast16_t]: number of samples
+// @returns:    None
+// *****************************************************************************
+void DSP_IIRBlock(DSP_IIR *f, const int16_t *in, int16_t *out, uint_fast16_t count);
+
+
+#endif	// _NANOLAY_DSP_H
@@ -857,4 +857,129 @@ void __attribute__ ((interrupt, no_auto_psv)) _CCP7Interrupt (void){
     // drive GPIO low at pulse width compare 
     IFS9bits.CCP7IF = false;
     LATB = LATB & (~pwmb3.pin);
-}
\ No newline at end of file
+}
+
+
+
+
+// *****************************************************************************
+// SCCP8 is the single 32bit sample timer shared by the wave generator and the
+//      DAC stream. Its CCT8 ISR lives in nanolay_wavgen.c
+// *****************************************************************************
+
+
+uint32_t SCCP_GetClkFreq(void){
+    uint32_t clock = 0;
+
+    switch( Sys_GetMasterClkFreq() ){
+        case FOSC_8MHZ:
+            clock = SCCP_CLK_FREQ_8MHZ;
+            break;
+        case FOSC_20MHZ:
+            clock = SCCP_CLK_FREQ_20MHZ;
+            break;
+        case FOSC_50MHZ:
+            clock = SCCP_CLK_FREQ_50MHZ;
+            break;
+        case FOSC_100MHZ:
+            clock = SCCP_CLK_FREQ_100MHZ;
+            break;
+    }
+    return clock;
+}
+
+
+void SCCP8_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t period, uint_fast8_t priority){
+    IPC38bits.CCT8IP = priority;
+    
+    uint_fast32_t val = period - 1;                                             // timer counts 0 to PR
+
+    PMD2bits.CCP8MD = 0;                                                        // enable SCCP8 peripheral
+
+    CCP8CON1Lbits.CCPON = false;                                                // make sure module is disabled at initialization
+    CCP8CON1Lbits.CCPSIDL = !activeOnIdle;
+    CCP8CON1Lbits.CCPSLP = activeOnSleep;
+    CCP8CON1Lbits.CLKSEL = 0x0;                                                 // FOSC/2 is the clock source
+    CCP8CON1Lbits.TMRPS = 0;                                                    // 1:1 prescaler
+    CCP8CON1Lbits.TMRSYNC = 0;                                                  // sync enabled
+    CCP8CON1Lbits.T32 = 1;                                                      // SCCP8 is a single 32bit timer
+    CCP8CON1Lbits.CCSEL = 0;                                                    // Timer mode
+    CCP8CON1Lbits.MOD = 0x0;                                                    // 16-Bit/32-Bit Timer mode, output functions are disabled
+
+    CCP8CON1H = 0x0000;                                                         // RTRGEN disabled; ALTSYNC disabled; ONESHOT disabled; TRIGEN disabled; OPS Each Time Base Period Match; SYNC None; OPSSRC Timer Interrupt Event;
+    CCP8CON2L = 0x0000;                                                         // ASDGM disabled; SSDG disabled; ASDG 0; PWMRSEN disabled; 
+    CCP8CON2H = 0x0000;                                                         // ICGSM Level-Sensitive mode; ICSEL IC1; AUXOUT Disabled; OCAEN disabled; OENSYNC disabled; 
+    CCP8CON3H = 0x0000;                                                         // OETRIG disabled; OSCNT None; POLACE disabled; PSSACE Tri-state; 
+    CCP8STATL = 0x0000;                                                         // ICDIS disabled; SCEVT disabled; TRSET disabled; ICOV disabled; ASEVT disabled; ICGARM disabled; TRCLR disabled; 
+    CCP8PRL = 0x0000;                                                           // initially set primary timer period to 0
+    CCP8PRH = 0x0000;                                                           // initially set secondary timer period to 0
+    CCP8TMRL = 0x00;                                                            // TMR 0; 
+    CCP8TMRH = 0x00;                                                            // TMR 0; 
+    CCP8RA = 0x00;                                                              // CMP 0; 
+    CCP8RB = 0x00;                                                              // CMP 0;
+    CCP8BUFL = 0x00;                                                            // BUF 0; 
+    CCP8BUFH = 0x00;                                                            // BUF 0;
+
+    CCP8PRL = (val & 0x0000FFFF);
+    CCP8PRH = ((val & 0xFFFF0000) >> 16);
+
+    IEC9bits.CCT8IE = false;
+    IEC9bits.CCP8IE = false;
+}
+
+
+
+
+// *****************************************************************************
+// SCCP7 as the ADC trigger timer, shares the module with PWMB3
+// *****************************************************************************
+
+
+uint_fast32_t SCCP7_TriggerInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t period){
+    uint_fast8_t prescaler = 0;                                                 // 1:1, 1:4, 1:16, 1:64
+
+    if (period < SCCP7_MIN_PERIOD){
+        period = SCCP7_MIN_PERIOD;
+    }
+    while (((period >> (2 * prescaler)) > 0x10000UL) && (prescaler < 3)){
+        prescaler++;
+    }
+    period = (period + (1UL << (2 * prescaler)) / 2) >> (2 * prescaler);        // in prescaled ticks, rounded
+    if (period > 0x10000UL){
+        period = 0x10000UL;
+    }
+    else if (period < SCCP7_MIN_PERIOD){
+        period = SCCP7_MIN_PERIOD;
+    }
+
+    PMD2bits.CCP7MD = 0;                                                        // enable SCCP7 peripheral
+
+    CCP7CON1Lbits.CCPON = false;                                                // make sure module is disabled at initialization
+    CCP7CON1Lbits.CCPSIDL = !activeOnIdle;
+    CCP7CON1Lbits.CCPSLP = activeOnSleep;
+    CCP7CON1Lbits.CLKSEL = 0x0;                                                 // FOSC/2 is the clock source
+    CCP7CON1Lbits.TMRPS = prescaler;
+    CCP7CON1Lbits.TMRSYNC = 0;                                                  // sync enabled
+    CCP7CON1Lbits.T32 = 0;                                                      // compare modes work only at 16bit
+    CCP7CON1Lbits.CCSEL = 0;                                                    // compare mode
+    CCP7CON1Lbits.MOD = 0x5;                                                    // Dual Edge Compare mode, buffered, one compare event per period
+
+    CCP7CON1H = 0x0000;                                                         // RTRGEN disabled; ALTSYNC disabled; ONESHOT disabled; TRIGEN disabled; OPS Each Time Base Period Match; SYNC None; OPSSRC Timer Interrupt Event;
+    CCP7CON2L = 0x0000;                                                         // ASDGM disabled; SSDG disabled; ASDG 0; PWMRSEN disabled;
+    CCP7CON2H = 0x0000;                                                         // ICGSM Level-Sensitive mode; ICSEL IC1; AUXOUT Disabled; OCAEN disabled; OENSYNC disabled;
+    CCP7CON3H = 0x0000;                                                         // OETRIG disabled; OSCNT None; POLACE disabled; PSSACE Tri-state;
+    CCP7STATL = 0x0000;                                                         // ICDIS disabled; SCEVT disabled; TRSET disabled; ICOV disabled; ASEVT disabled; ICGARM disabled; TRCLR disabled;
+
+    CCP7PRH = 0x0000;
+    CCP7TMRL = 0x0000;
+    CCP7TMRH = 0x0000;
+    CCP7RA = 0x0000;                                                            // rising edge at the start of the period
+    CCP7RB = 0x0001;                                                            // falling edge one tick later is the trigger event
+    CCP7BUFL = 0x0000;
+    CCP7BUFH = 0x0000;
+    CCP7PRL = period - 1;                                                       // timer counts 0 to PR
+
+    IEC9bits.CCP7IE = false;
+    IEC9bits.CCT7IE = false;
+    return period << (2 * prescaler);
+}
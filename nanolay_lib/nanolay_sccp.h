@@ -31,8 +31,17 @@
 #define SCCP_1MS_COUNT_50MHZ    24999
 #define SCCP_1MS_COUNT_100MHZ   49999
 
+// SCCP clock frequency in Hz @ FOSC/2 clock
+#define SCCP_CLK_FREQ_8MHZ      4000000UL
+#define SCCP_CLK_FREQ_20MHZ     10000000UL
+#define SCCP_CLK_FREQ_50MHZ     25000000UL
+#define SCCP_CLK_FREQ_100MHZ    50000000UL
+
 
 #define SCCP_PWM_MIN_PERIOD     40                                              // Maximum frequency of 25kHz
+#define SCCP8_MIN_PERIOD        2                                               // shortest SCCP8 period in Fcy ticks
+#define SCCP8_ISR_MIN_PERIOD    100                                             // shortest SCCP8 period with a sample ISR, 100kHz at Fosc = 20MHz
+#define SCCP7_MIN_PERIOD        2                                               // shortest SCCP7 trigger period in Fcy ticks
 
 
 typedef struct tmr2_obj {
@@ -430,4 +439,67 @@ void PWMB3_Start(void);
 void PWMB3_Stop(void);
 
 
+
+
+
+// *****************************************************************************
+// *****************************************************************************
+// SCCP8 is the single 32bit sample timer shared by the wave generator and the
+//      DAC stream. Its CCT8 ISR lives in nanolay_wavgen.c, DMA streaming only
+//      uses the timer event as a trigger
+// *****************************************************************************
+// *****************************************************************************
+
+
+// *****************************************************************************
+// @desc:       Returns the SCCP clock frequency, Fosc/2, for the clock set by
+//                  Sys_Init()
+// @args:       None
+// @returns:    [uint32_t]: clock frequency in Hz
+// *****************************************************************************
+uint32_t SCCP_GetClkFreq(void);
+
+
+// *****************************************************************************
+// @desc:       Initializes the SCCP8 module and used as a 32bit timer clocked
+//                  at Fcy = Fosc/2, so the sample period has one Fcy tick
+//                  (20ns at Fosc = 100MHz) resolution
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              period [uint_fast32_t]: interval in Fcy ticks, minimum
+//                  SCCP8_MIN_PERIOD with DMA streaming. The wave generator
+//                  modes that run the sample ISR clamp the period to
+//                  SCCP8_ISR_MIN_PERIOD, a shorter one would leave no CPU time
+//                  outside the ISR
+//              priority [uint_fast8_t]: interrupt priority
+// @returns:    None
+// *****************************************************************************
+void SCCP8_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t period, uint_fast8_t priority);
+
+
+
+
+// *****************************************************************************
+// *****************************************************************************
+// SCCP7 doubles as the ADC trigger timer. Its compare event starts the ADC
+//      conversions and the DMA transfers of the ADC stream, no interrupt is
+//      used. Cannot be used together with PWMB3
+// *****************************************************************************
+// *****************************************************************************
+
+
+// *****************************************************************************
+// @desc:       Initializes SCCP7 as a 16bit periodic trigger. The prescaler is
+//                  picked automatically, so periods above 65536 Fcy ticks lose
+//                  resolution. Output pin and interrupts stay disabled, set
+//                  CCP7CON1Lbits.CCPON to start it
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              period [uint_fast32_t]: interval in Fcy ticks, minimum
+//                  SCCP7_MIN_PERIOD, maximum 64 * 65536
+// @returns:    [uint_fast32_t]: actual interval in Fcy ticks
+// *****************************************************************************
+uint_fast32_t SCCP7_TriggerInit(bool activeOnIdle, bool activeOnSleep, uint_fast32_t period);
+
+
 #endif // _NANOLAY_SCCP_H
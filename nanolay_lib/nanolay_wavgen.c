@@ -13,238 +13,1097 @@
 /* ************************************************************************** */
 
 #include "nanolay_wavgen.h"
+#include <math.h>
 
 
-uint_fast16_t sineTable[SAMPLE_SIZE] = {
-0x0800,0x0807,0x080e,0x0815,0x081c,0x0824,0x082b,0x0832,0x0839,0x0841,0x0848,0x084f,0x0856,0x085e,0x0865,0x086c,
-0x0873,0x087a,0x0882,0x0889,0x0890,0x0897,0x089e,0x08a6,0x08ad,0x08b4,0x08bb,0x08c2,0x08ca,0x08d1,0x08d8,0x08df,
-0x08e6,0x08ee,0x08f5,0x08fc,0x0903,0x090a,0x0911,0x0919,0x0920,0x0927,0x092e,0x0935,0x093c,0x0943,0x094b,0x0952,
-0x0959,0x0960,0x0967,0x096e,0x0975,0x097c,0x0983,0x098a,0x0991,0x0998,0x09a0,0x09a7,0x09ae,0x09b5,0x09bc,0x09c3,
-0x09ca,0x09d1,0x09d8,0x09df,0x09e6,0x09ed,0x09f4,0x09fb,0x0a02,0x0a08,0x0a0f,0x0a16,0x0a1d,0x0a24,0x0a2b,0x0a32,
-0x0a39,0x0a40,0x0a47,0x0a4d,0x0a54,0x0a5b,0x0a62,0x0a69,0x0a70,0x0a76,0x0a7d,0x0a84,0x0a8b,0x0a92,0x0a98,0x0a9f,
-0x0aa6,0x0aac,0x0ab3,0x0aba,0x0ac1,0x0ac7,0x0ace,0x0ad5,0x0adb,0x0ae2,0x0ae9,0x0aef,0x0af6,0x0afc,0x0b03,0x0b09,
-0x0b10,0x0b17,0x0b1d,0x0b24,0x0b2a,0x0b31,0x0b37,0x0b3e,0x0b44,0x0b4a,0x0b51,0x0b57,0x0b5e,0x0b64,0x0b6a,0x0b71,
-0x0b77,0x0b7d,0x0b84,0x0b8a,0x0b90,0x0b97,0x0b9d,0x0ba3,0x0ba9,0x0bb0,0x0bb6,0x0bbc,0x0bc2,0x0bc8,0x0bcf,0x0bd5,
-0x0bdb,0x0be1,0x0be7,0x0bed,0x0bf3,0x0bf9,0x0bff,0x0c05,0x0c0b,0x0c11,0x0c17,0x0c1d,0x0c23,0x0c29,0x0c2f,0x0c35,
-0x0c3a,0x0c40,0x0c46,0x0c4c,0x0c52,0x0c58,0x0c5d,0x0c63,0x0c69,0x0c6e,0x0c74,0x0c7a,0x0c80,0x0c85,0x0c8b,0x0c90,
-0x0c96,0x0c9c,0x0ca1,0x0ca7,0x0cac,0x0cb2,0x0cb7,0x0cbd,0x0cc2,0x0cc7,0x0ccd,0x0cd2,0x0cd8,0x0cdd,0x0ce2,0x0ce7,
-0x0ced,0x0cf2,0x0cf7,0x0cfd,0x0d02,0x0d07,0x0d0c,0x0d11,0x0d16,0x0d1b,0x0d21,0x0d26,0x0d2b,0x0d30,0x0d35,0x0d3a,
-0x0d3f,0x0d44,0x0d48,0x0d4d,0x0d52,0x0d57,0x0d5c,0x0d61,0x0d66,0x0d6a,0x0d6f,0x0d74,0x0d79,0x0d7d,0x0d82,0x0d87,
-0x0d8b,0x0d90,0x0d94,0x0d99,0x0d9d,0x0da2,0x0da6,0x0dab,0x0daf,0x0db4,0x0db8,0x0dbd,0x0dc1,0x0dc5,0x0dca,0x0dce,
-0x0dd2,0x0dd6,0x0ddb,0x0ddf,0x0de3,0x0de7,0x0deb,0x0def,0x0df3,0x0df7,0x0dfb,0x0dff,0x0e03,0x0e07,0x0e0b,0x0e0f,
-0x0e13,0x0e17,0x0e1b,0x0e1f,0x0e22,0x0e26,0x0e2a,0x0e2e,0x0e31,0x0e35,0x0e39,0x0e3c,0x0e40,0x0e44,0x0e47,0x0e4b,
-0x0e4e,0x0e52,0x0e55,0x0e58,0x0e5c,0x0e5f,0x0e63,0x0e66,0x0e69,0x0e6c,0x0e70,0x0e73,0x0e76,0x0e79,0x0e7c,0x0e80,
-0x0e83,0x0e86,0x0e89,0x0e8c,0x0e8f,0x0e92,0x0e95,0x0e98,0x0e9a,0x0e9d,0x0ea0,0x0ea3,0x0ea6,0x0ea9,0x0eab,0x0eae,
-0x0eb1,0x0eb3,0x0eb6,0x0eb8,0x0ebb,0x0ebe,0x0ec0,0x0ec3,0x0ec5,0x0ec8,0x0eca,0x0ecc,0x0ecf,0x0ed1,0x0ed3,0x0ed6,
-0x0ed8,0x0eda,0x0edc,0x0ede,0x0ee1,0x0ee3,0x0ee5,0x0ee7,0x0ee9,0x0eeb,0x0eed,0x0eef,0x0ef1,0x0ef3,0x0ef4,0x0ef6,
-0x0ef8,0x0efa,0x0efc,0x0efd,0x0eff,0x0f01,0x0f02,0x0f04,0x0f06,0x0f07,0x0f09,0x0f0a,0x0f0c,0x0f0d,0x0f0f,0x0f10,
-0x0f11,0x0f13,0x0f14,0x0f15,0x0f17,0x0f18,0x0f19,0x0f1a,0x0f1b,0x0f1c,0x0f1e,0x0f1f,0x0f20,0x0f21,0x0f22,0x0f23,
-0x0f23,0x0f24,0x0f25,0x0f26,0x0f27,0x0f28,0x0f28,0x0f29,0x0f2a,0x0f2a,0x0f2b,0x0f2c,0x0f2c,0x0f2d,0x0f2d,0x0f2e,
-0x0f2e,0x0f2f,0x0f2f,0x0f30,0x0f30,0x0f30,0x0f31,0x0f31,0x0f31,0x0f31,0x0f31,0x0f32,0x0f32,0x0f32,0x0f32,0x0f32,
-0x0f32,0x0f32,0x0f32,0x0f32,0x0f32,0x0f32,0x0f31,0x0f31,0x0f31,0x0f31,0x0f31,0x0f30,0x0f30,0x0f30,0x0f2f,0x0f2f,
-0x0f2e,0x0f2e,0x0f2d,0x0f2d,0x0f2c,0x0f2c,0x0f2b,0x0f2a,0x0f2a,0x0f29,0x0f28,0x0f28,0x0f27,0x0f26,0x0f25,0x0f24,
-0x0f23,0x0f23,0x0f22,0x0f21,0x0f20,0x0f1f,0x0f1e,0x0f1c,0x0f1b,0x0f1a,0x0f19,0x0f18,0x0f17,0x0f15,0x0f14,0x0f13,
-0x0f11,0x0f10,0x0f0f,0x0f0d,0x0f0c,0x0f0a,0x0f09,0x0f07,0x0f06,0x0f04,0x0f02,0x0f01,0x0eff,0x0efd,0x0efc,0x0efa,
-0x0ef8,0x0ef6,0x0ef4,0x0ef3,0x0ef1,0x0eef,0x0eed,0x0eeb,0x0ee9,0x0ee7,0x0ee5,0x0ee3,0x0ee1,0x0ede,0x0edc,0x0eda,
-0x0ed8,0x0ed6,0x0ed3,0x0ed1,0x0ecf,0x0ecc,0x0eca,0x0ec8,0x0ec5,0x0ec3,0x0ec0,0x0ebe,0x0ebb,0x0eb8,0x0eb6,0x0eb3,
-0x0eb1,0x0eae,0x0eab,0x0ea9,0x0ea6,0x0ea3,0x0ea0,0x0e9d,0x0e9a,0x0e98,0x0e95,0x0e92,0x0e8f,0x0e8c,0x0e89,0x0e86,
-0x0e83,0x0e80,0x0e7c,0x0e79,0x0e76,0x0e73,0x0e70,0x0e6c,0x0e69,0x0e66,0x0e63,0x0e5f,0x0e5c,0x0e58,0x0e55,0x0e52,
-0x0e4e,0x0e4b,0x0e47,0x0e44,0x0e40,0x0e3c,0x0e39,0x0e35,0x0e31,0x0e2e,0x0e2a,0x0e26,0x0e22,0x0e1f,0x0e1b,0x0e17,
-0x0e13,0x0e0f,0x0e0b,0x0e07,0x0e03,0x0dff,0x0dfb,0x0df7,0x0df3,0x0def,0x0deb,0x0de7,0x0de3,0x0ddf,0x0ddb,0x0dd6,
-0x0dd2,0x0dce,0x0dca,0x0dc5,0x0dc1,0x0dbd,0x0db8,0x0db4,0x0daf,0x0dab,0x0da6,0x0da2,0x0d9d,0x0d99,0x0d94,0x0d90,
-0x0d8b,0x0d87,0x0d82,0x0d7d,0x0d79,0x0d74,0x0d6f,0x0d6a,0x0d66,0x0d61,0x0d5c,0x0d57,0x0d52,0x0d4d,0x0d48,0x0d44,
-0x0d3f,0x0d3a,0x0d35,0x0d30,0x0d2b,0x0d26,0x0d21,0x0d1b,0x0d16,0x0d11,0x0d0c,0x0d07,0x0d02,0x0cfd,0x0cf7,0x0cf2,
-0x0ced,0x0ce7,0x0ce2,0x0cdd,0x0cd8,0x0cd2,0x0ccd,0x0cc7,0x0cc2,0x0cbd,0x0cb7,0x0cb2,0x0cac,0x0ca7,0x0ca1,0x0c9c,
-0x0c96,0x0c90,0x0c8b,0x0c85,0x0c80,0x0c7a,0x0c74,0x0c6e,0x0c69,0x0c63,0x0c5d,0x0c58,0x0c52,0x0c4c,0x0c46,0x0c40,
-0x0c3a,0x0c35,0x0c2f,0x0c29,0x0c23,0x0c1d,0x0c17,0x0c11,0x0c0b,0x0c05,0x0bff,0x0bf9,0x0bf3,0x0bed,0x0be7,0x0be1,
-0x0bdb,0x0bd5,0x0bcf,0x0bc8,0x0bc2,0x0bbc,0x0bb6,0x0bb0,0x0ba9,0x0ba3,0x0b9d,0x0b97,0x0b90,0x0b8a,0x0b84,0x0b7d,
-0x0b77,0x0b71,0x0b6a,0x0b64,0x0b5e,0x0b57,0x0b51,0x0b4a,0x0b44,0x0b3e,0x0b37,0x0b31,0x0b2a,0x0b24,0x0b1d,0x0b17,
-0x0b10,0x0b09,0x0b03,0x0afc,0x0af6,0x0aef,0x0ae9,0x0ae2,0x0adb,0x0ad5,0x0ace,0x0ac7,0x0ac1,0x0aba,0x0ab3,0x0aac,
-0x0aa6,0x0a9f,0x0a98,0x0a92,0x0a8b,0x0a84,0x0a7d,0x0a76,0x0a70,0x0a69,0x0a62,0x0a5b,0x0a54,0x0a4d,0x0a47,0x0a40,
-0x0a39,0x0a32,0x0a2b,0x0a24,0x0a1d,0x0a16,0x0a0f,0x0a08,0x0a02,0x09fb,0x09f4,0x09ed,0x09e6,0x09df,0x09d8,0x09d1,
-0x09ca,0x09c3,0x09bc,0x09b5,0x09ae,0x09a7,0x09a0,0x0998,0x0991,0x098a,0x0983,0x097c,0x0975,0x096e,0x0967,0x0960,
-0x0959,0x0952,0x094b,0x0943,0x093c,0x0935,0x092e,0x0927,0x0920,0x0919,0x0911,0x090a,0x0903,0x08fc,0x08f5,0x08ee,
-0x08e6,0x08df,0x08d8,0x08d1,0x08ca,0x08c2,0x08bb,0x08b4,0x08ad,0x08a6,0x089e,0x0897,0x0890,0x0889,0x0882,0x087a,
-0x0873,0x086c,0x0865,0x085e,0x0856,0x084f,0x0848,0x0841,0x0839,0x0832,0x082b,0x0824,0x081c,0x0815,0x080e,0x0807,
-0x0800,0x07f8,0x07f1,0x07ea,0x07e3,0x07db,0x07d4,0x07cd,0x07c6,0x07be,0x07b7,0x07b0,0x07a9,0x07a1,0x079a,0x0793,
-0x078c,0x0785,0x077d,0x0776,0x076f,0x0768,0x0761,0x0759,0x0752,0x074b,0x0744,0x073d,0x0735,0x072e,0x0727,0x0720,
-0x0719,0x0711,0x070a,0x0703,0x06fc,0x06f5,0x06ee,0x06e6,0x06df,0x06d8,0x06d1,0x06ca,0x06c3,0x06bc,0x06b4,0x06ad,
-0x06a6,0x069f,0x0698,0x0691,0x068a,0x0683,0x067c,0x0675,0x066e,0x0667,0x065f,0x0658,0x0651,0x064a,0x0643,0x063c,
-0x0635,0x062e,0x0627,0x0620,0x0619,0x0612,0x060b,0x0604,0x05fd,0x05f7,0x05f0,0x05e9,0x05e2,0x05db,0x05d4,0x05cd,
-0x05c6,0x05bf,0x05b8,0x05b2,0x05ab,0x05a4,0x059d,0x0596,0x058f,0x0589,0x0582,0x057b,0x0574,0x056d,0x0567,0x0560,
-0x0559,0x0553,0x054c,0x0545,0x053e,0x0538,0x0531,0x052a,0x0524,0x051d,0x0516,0x0510,0x0509,0x0503,0x04fc,0x04f6,
-0x04ef,0x04e8,0x04e2,0x04db,0x04d5,0x04ce,0x04c8,0x04c1,0x04bb,0x04b5,0x04ae,0x04a8,0x04a1,0x049b,0x0495,0x048e,
-0x0488,0x0482,0x047b,0x0475,0x046f,0x0468,0x0462,0x045c,0x0456,0x044f,0x0449,0x0443,0x043d,0x0437,0x0430,0x042a,
-0x0424,0x041e,0x0418,0x0412,0x040c,0x0406,0x0400,0x03fa,0x03f4,0x03ee,0x03e8,0x03e2,0x03dc,0x03d6,0x03d0,0x03ca,
-0x03c5,0x03bf,0x03b9,0x03b3,0x03ad,0x03a7,0x03a2,0x039c,0x0396,0x0391,0x038b,0x0385,0x037f,0x037a,0x0374,0x036f,
-0x0369,0x0363,0x035e,0x0358,0x0353,0x034d,0x0348,0x0342,0x033d,0x0338,0x0332,0x032d,0x0327,0x0322,0x031d,0x0318,
-0x0312,0x030d,0x0308,0x0302,0x02fd,0x02f8,0x02f3,0x02ee,0x02e9,0x02e4,0x02de,0x02d9,0x02d4,0x02cf,0x02ca,0x02c5,
-0x02c0,0x02bb,0x02b7,0x02b2,0x02ad,0x02a8,0x02a3,0x029e,0x0299,0x0295,0x0290,0x028b,0x0286,0x0282,0x027d,0x0278,
-0x0274,0x026f,0x026b,0x0266,0x0262,0x025d,0x0259,0x0254,0x0250,0x024b,0x0247,0x0242,0x023e,0x023a,0x0235,0x0231,
-0x022d,0x0229,0x0224,0x0220,0x021c,0x0218,0x0214,0x0210,0x020c,0x0208,0x0204,0x0200,0x01fc,0x01f8,0x01f4,0x01f0,
-0x01ec,0x01e8,0x01e4,0x01e0,0x01dd,0x01d9,0x01d5,0x01d1,0x01ce,0x01ca,0x01c6,0x01c3,0x01bf,0x01bb,0x01b8,0x01b4,
-0x01b1,0x01ad,0x01aa,0x01a7,0x01a3,0x01a0,0x019c,0x0199,0x0196,0x0193,0x018f,0x018c,0x0189,0x0186,0x0183,0x017f,
-0x017c,0x0179,0x0176,0x0173,0x0170,0x016d,0x016a,0x0167,0x0165,0x0162,0x015f,0x015c,0x0159,0x0156,0x0154,0x0151,
-0x014e,0x014c,0x0149,0x0147,0x0144,0x0141,0x013f,0x013c,0x013a,0x0137,0x0135,0x0133,0x0130,0x012e,0x012c,0x0129,
-0x0127,0x0125,0x0123,0x0121,0x011e,0x011c,0x011a,0x0118,0x0116,0x0114,0x0112,0x0110,0x010e,0x010c,0x010b,0x0109,
-0x0107,0x0105,0x0103,0x0102,0x0100,0x00fe,0x00fd,0x00fb,0x00f9,0x00f8,0x00f6,0x00f5,0x00f3,0x00f2,0x00f0,0x00ef,
-0x00ee,0x00ec,0x00eb,0x00ea,0x00e8,0x00e7,0x00e6,0x00e5,0x00e4,0x00e3,0x00e1,0x00e0,0x00df,0x00de,0x00dd,0x00dc,
-0x00dc,0x00db,0x00da,0x00d9,0x00d8,0x00d7,0x00d7,0x00d6,0x00d5,0x00d5,0x00d4,0x00d3,0x00d3,0x00d2,0x00d2,0x00d1,
-0x00d1,0x00d0,0x00d0,0x00cf,0x00cf,0x00cf,0x00ce,0x00ce,0x00ce,0x00ce,0x00ce,0x00cd,0x00cd,0x00cd,0x00cd,0x00cd,
-0x00cd,0x00cd,0x00cd,0x00cd,0x00cd,0x00cd,0x00ce,0x00ce,0x00ce,0x00ce,0x00ce,0x00cf,0x00cf,0x00cf,0x00d0,0x00d0,
-0x00d1,0x00d1,0x00d2,0x00d2,0x00d3,0x00d3,0x00d4,0x00d5,0x00d5,0x00d6,0x00d7,0x00d7,0x00d8,0x00d9,0x00da,0x00db,
-0x00dc,0x00dc,0x00dd,0x00de,0x00df,0x00e0,0x00e1,0x00e3,0x00e4,0x00e5,0x00e6,0x00e7,0x00e8,0x00ea,0x00eb,0x00ec,
-0x00ee,0x00ef,0x00f0,0x00f2,0x00f3,0x00f5,0x00f6,0x00f8,0x00f9,0x00fb,0x00fd,0x00fe,0x0100,0x0102,0x0103,0x0105,
-0x0107,0x0109,0x010b,0x010c,0x010e,0x0110,0x0112,0x0114,0x0116,0x0118,0x011a,0x011c,0x011e,0x0121,0x0123,0x0125,
-0x0127,0x0129,0x012c,0x012e,0x0130,0x0133,0x0135,0x0137,0x013a,0x013c,0x013f,0x0141,0x0144,0x0147,0x0149,0x014c,
-0x014e,0x0151,0x0154,0x0156,0x0159,0x015c,0x015f,0x0162,0x0165,0x0167,0x016a,0x016d,0x0170,0x0173,0x0176,0x0179,
-0x017c,0x017f,0x0183,0x0186,0x0189,0x018c,0x018f,0x0193,0x0196,0x0199,0x019c,0x01a0,0x01a3,0x01a7,0x01aa,0x01ad,
-0x01b1,0x01b4,0x01b8,0x01bb,0x01bf,0x01c3,0x01c6,0x01ca,0x01ce,0x01d1,0x01d5,0x01d9,0x01dd,0x01e0,0x01e4,0x01e8,
-0x01ec,0x01f0,0x01f4,0x01f8,0x01fc,0x0200,0x0204,0x0208,0x020c,0x0210,0x0214,0x0218,0x021c,0x0220,0x0224,0x0229,
-0x022d,0x0231,0x0235,0x023a,0x023e,0x0242,0x0247,0x024b,0x0250,0x0254,0x0259,0x025d,0x0262,0x0266,0x026b,0x026f,
-0x0274,0x0278,0x027d,0x0282,0x0286,0x028b,0x0290,0x0295,0x0299,0x029e,0x02a3,0x02a8,0x02ad,0x02b2,0x02b7,0x02bb,
-0x02c0,0x02c5,0x02ca,0x02cf,0x02d4,0x02d9,0x02de,0x02e4,0x02e9,0x02ee,0x02f3,0x02f8,0x02fd,0x0302,0x0308,0x030d,
-0x0312,0x0318,0x031d,0x0322,0x0327,0x032d,0x0332,0x0338,0x033d,0x0342,0x0348,0x034d,0x0353,0x0358,0x035e,0x0363,
-0x0369,0x036f,0x0374,0x037a,0x037f,0x0385,0x038b,0x0391,0x0396,0x039c,0x03a2,0x03a7,0x03ad,0x03b3,0x03b9,0x03bf,
-0x03c5,0x03ca,0x03d0,0x03d6,0x03dc,0x03e2,0x03e8,0x03ee,0x03f4,0x03fa,0x0400,0x0406,0x040c,0x0412,0x0418,0x041e,
-0x0424,0x042a,0x0430,0x0437,0x043d,0x0443,0x0449,0x044f,0x0456,0x045c,0x0462,0x0468,0x046f,0x0475,0x047b,0x0482,
-0x0488,0x048e,0x0495,0x049b,0x04a1,0x04a8,0x04ae,0x04b5,0x04bb,0x04c1,0x04c8,0x04ce,0x04d5,0x04db,0x04e2,0x04e8,
-0x04ef,0x04f6,0x04fc,0x0503,0x0509,0x0510,0x0516,0x051d,0x0524,0x052a,0x0531,0x0538,0x053e,0x0545,0x054c,0x0553,
-0x0559,0x0560,0x0567,0x056d,0x0574,0x057b,0x0582,0x0589,0x058f,0x0596,0x059d,0x05a4,0x05ab,0x05b2,0x05b8,0x05bf,
-0x05c6,0x05cd,0x05d4,0x05db,0x05e2,0x05e9,0x05f0,0x05f7,0x05fd,0x0604,0x060b,0x0612,0x0619,0x0620,0x0627,0x062e,
-0x0635,0x063c,0x0643,0x064a,0x0651,0x0658,0x065f,0x0667,0x066e,0x0675,0x067c,0x0683,0x068a,0x0691,0x0698,0x069f,
-0x06a6,0x06ad,0x06b4,0x06bc,0x06c3,0x06ca,0x06d1,0x06d8,0x06df,0x06e6,0x06ee,0x06f5,0x06fc,0x0703,0x070a,0x0711,
-0x0719,0x0720,0x0727,0x072e,0x0735,0x073d,0x0744,0x074b,0x0752,0x0759,0x0761,0x0768,0x076f,0x0776,0x077d,0x0785,
-0x078c,0x0793,0x079a,0x07a1,0x07a9,0x07b0,0x07b7,0x07be,0x07c6,0x07cd,0x07d4,0x07db,0x07e3,0x07ea,0x07f1,0x07f8
-};
+static volatile WAV_Mode wavMode = WAV_MODE_SINE;
+WAV_Sine sineWave;
+WAV_Arb arbWave;
+WAV_Slope slopeWave;
+WAV_Sweep sweepWave;
+WAV_MultiTone multiTone;
+WAV_Burst burstWave;
+WAV_Mod modWave;
+WAV_Noise noiseWave;
+WAV_ClipPlayer clipPlayer;
+void (*WAV_Sweep_CompleteHandler)(void) = NULL;
+void (*WAV_Sine_UpdateHandler)(void) = NULL;
+void (*WAV_Burst_CompleteHandler)(void) = NULL;
+static int16_t wavQTable[SINE_QTABLE_SIZE + 1];                                 // sineQTable with the DAC1 correction folded in
+static int16_t wavMidscale = SINE_MIDSCALE;                                     // DAC1 code of 0V out, corrected
+static int16_t wavMixScale = WAV_MIX_SCALE;                                     // Q15 full scale in DAC LSB, corrected
+static uint32_t wavPeriod = 1;                                                  // SCCP8 ticks per sample
+static uint32_t wavClock = 0;                                                   // SCCP8 clock in Hz
 
 
-WAV_Sine sineWave;
+// Rounds the requested rate to the nearest whole SCCP8 period, not below
+// minPeriod, and returns the rate actually produced, in Hz
+static uint_fast32_t WAV_SetSamplingRate(uint_fast32_t samplingFreq, uint_fast32_t minPeriod){
+    wavClock = SCCP_GetClkFreq();
+    if (samplingFreq == 0){
+        samplingFreq = 1;
+    }
+    wavPeriod = (wavClock + (samplingFreq / 2)) / samplingFreq;
+    if (wavPeriod < minPeriod){
+        wavPeriod = minPeriod;
+    }
+    return (wavClock + (wavPeriod / 2)) / wavPeriod;
+}
 
 
-void WAV_Sine_Init(bool activeOnIdle, bool activeOnSleep, uint_fast16_t freq, uint_fast32_t samplingFreq){
-    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
-    DAC_Init(activeOnIdle);
+static inline uint32_t WAV_TuningWord(uint_fast32_t freq_mHz){
+    return DDS_TuningWordPeriod(freq_mHz, wavPeriod, wavClock);
+}
 
-    sineWave.frequency = freq;
-    sineWave.samplingFrequency = samplingFreq;
-    sineWave.index = 1;
-    sineWave.stepSize = (int) (SAMPLE_SIZE / (sineWave.samplingFrequency / sineWave.frequency));
-    sineWave.samplingInterval = (int) (1000000 / sineWave.samplingFrequency);
-    SCCP8_Init(activeOnIdle, activeOnSleep, sineWave.samplingInterval, INT_PRIORITY);
+
+uint_fast32_t WAV_GetSamplingFrequency(void){
+    return (wavClock + (wavPeriod / 2)) / wavPeriod;
 }
 
 
-void WAV_Sine_Start(void){
+uint_fast32_t WAV_GetSamplingPeriod(void){
+    return wavPeriod;
+}
+
+
+uint_fast32_t WAV_BestSamplingFrequency(uint_fast32_t freq_mHz, uint_fast32_t minFreq, uint_fast32_t maxFreq){
+    uint32_t clock = SCCP_GetClkFreq();
+    uint32_t period;
+    uint32_t lastPeriod;
+    uint32_t bestPeriod;
+    uint32_t error;
+    uint32_t bestError = UINT32_MAX;
+
+    if ((minFreq == 0) || (maxFreq < minFreq)){
+        return maxFreq;
+    }
+    period = (clock + maxFreq - 1) / maxFreq;                                   // shortest period not above maxFreq
+    lastPeriod = clock / minFreq;                                               // longest period not below minFreq
+    if (period < SCCP8_ISR_MIN_PERIOD){
+        period = SCCP8_ISR_MIN_PERIOD;
+    }
+    if (lastPeriod > period + WAV_RATE_SEARCH - 1){
+        lastPeriod = period + WAV_RATE_SEARCH - 1;
+    }
+    bestPeriod = period;
+
+    for ( ; period <= lastPeriod; period++){                                    // ties keep the higher rate
+        error = DDS_FrequencyError(freq_mHz, period, clock);
+        if (error < bestError){
+            bestError = error;
+            bestPeriod = period;
+            if (error == 0){
+                break;
+            }
+        }
+    }
+    return (clock + (bestPeriod / 2)) / bestPeriod;
+}
+
+
+// Starts the SCCP8 sample interrupt of the current mode
+static void WAV_Timer_Start(void){
     IFS9bits.CCT8IF = false;                                                    // clear interrupt flag
     IEC9bits.CCT8IE = true;
     CCP8CON1Lbits.CCPON = true;
 }
 
 
-void WAV_Sine_Stop(void){
+// Stops the SCCP8 sample interrupt, shared by all ISR driven modes
+static void WAV_Timer_Stop(void){
     IEC9bits.CCT8IE = false;
     IEC9bits.CCP8IE = false;
     CCP8CON1Lbits.CCPON = false;
+    burstWave.remaining = 0;                                                    // an aborted burst does not carry over
 }
 
 
-void WAV_Sine_SetFrequency(uint_fast16_t freq){
-    sineWave.frequency = freq;
-    sineWave.stepSize = (int) (SAMPLE_SIZE / (sineWave.samplingFrequency / sineWave.frequency));
+// Folds the DAC1 calibration into the values the sample ISR adds up, so the
+// ISR itself is unchanged. The sine is odd around midscale, so the table can
+// only hold the odd part of the correction; the even part of the INL remains.
+// Without calibration the table is a plain copy of sineQTable.
+static void WAV_Cal_Fold(void){
+    uint_fast16_t i;
+
+    for (i = 0; i <= SINE_QTABLE_SIZE; i++){
+        wavQTable[i] = ((int16_t) DAC_CalApply(SINE_MIDSCALE + sineQTable[i]) - (int16_t) DAC_CalApply(SINE_MIDSCALE - sineQTable[i]) + 1) >> 1;
+    }
+    wavMidscale = DAC_CalApply(SINE_MIDSCALE);
+    wavMixScale = ((int16_t) DAC_CalApply(SINE_MIDSCALE + WAV_MIX_SCALE) - (int16_t) DAC_CalApply(SINE_MIDSCALE - WAV_MIX_SCALE) + 1) >> 1;
 }
 
 
-void SCCP8_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t interval_us, uint_fast8_t priority){
-    IPC38bits.CCT8IP = priority;
-    
-    Clock_Freq clk = Sys_GetMasterClkFreq();
-    uint_fast32_t val = 0;
+void WAV_Sine_Init(bool activeOnIdle, bool activeOnSleep, uint_fast16_t freq, uint_fast32_t samplingFreq){
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+    WAV_Cal_Fold();
+
+    sineWave.samplingFrequency = WAV_SetSamplingRate(samplingFreq, SCCP8_ISR_MIN_PERIOD);
+    sineWave.phase = 0;
+    sineWave.pending = false;
+    sineWave.stream = false;
+    sineWave.fixed = false;
+    sineWave.amplitude = WAV_FULL_SCALE;
+    IEC9bits.CCT8IE = false;                                                    // so the frequency below is applied right away
+    WAV_Sine_SetFrequency(freq);
+    wavMode = sineWave.interpolate ? WAV_MODE_SINE_INTERP : WAV_MODE_SINE;
+    SCCP8_Init(activeOnIdle, activeOnSleep, wavPeriod, INT_PRIORITY);
+}
 
-    PMD2bits.CCP8MD = 0;                                                        // enable SCCP8 peripheral
 
-    CCP8CON1Lbits.CCPON = false;                                                // make sure module is disabled at initialization
-    CCP8CON1Lbits.CCPSIDL = !activeOnIdle;
-    CCP8CON1Lbits.CCPSLP = activeOnSleep;
-    CCP8CON1Lbits.CLKSEL = 0x0;                                                 // FOSC/2 is the clock source
-    CCP8CON1Lbits.TMRPS = 0;                                                    // 1:1 prescaler
-    CCP8CON1Lbits.TMRSYNC = 0;                                                  // sync enabled
-    CCP8CON1Lbits.T32 = 1;                                                      // SCCP8 is a single 32bit timer
-    CCP8CON1Lbits.CCSEL = 0;                                                    // Timer mode
-    CCP8CON1Lbits.MOD = 0x0;                                                    // 16-Bit/32-Bit Timer mode, output functions are disabled
+static inline int16_t WAV_Scale(int16_t sample, int16_t amplitude){
+    return (int16_t) ((__builtin_mulss(sample, amplitude) + 0x4000) >> 15);     // Q15 multiply, rounded
+}
 
-    CCP8CON1H = 0x0000;                                                         // RTRGEN disabled; ALTSYNC disabled; ONESHOT disabled; TRIGEN disabled; OPS Each Time Base Period Match; SYNC None; OPSSRC Timer Interrupt Event;
-    CCP8CON2L = 0x0000;                                                         // ASDGM disabled; SSDG disabled; ASDG 0; PWMRSEN disabled; 
-    CCP8CON2H = 0x0000;                                                         // ICGSM Level-Sensitive mode; ICSEL IC1; AUXOUT Disabled; OCAEN disabled; OENSYNC disabled; 
-    CCP8CON3H = 0x0000;                                                         // OETRIG disabled; OSCNT None; POLACE disabled; PSSACE Tri-state; 
-    CCP8STATL = 0x0000;                                                         // ICDIS disabled; SCEVT disabled; TRSET disabled; ICOV disabled; ASEVT disabled; ICGARM disabled; TRCLR disabled; 
-    CCP8PRL = 0x0000;                                                           // initially set primary timer period to 0
-    CCP8PRH = 0x0000;                                                           // initially set secondary timer period to 0
-    CCP8TMRL = 0x00;                                                            // TMR 0; 
-    CCP8TMRH = 0x00;                                                            // TMR 0; 
-    CCP8RA = 0x00;                                                              // CMP 0; 
-    CCP8RB = 0x00;                                                              // CMP 0;
-    CCP8BUFL = 0x00;                                                            // BUF 0; 
-    CCP8BUFH = 0x00;                                                            // BUF 0;
 
-    switch( clk ){
-        case FOSC_8MHZ:
-            val = (interval_us * SCCP_1US_COUNT_8MHZ) - 1;
-            break;
-        case FOSC_20MHZ:
-            val = (interval_us * SCCP_1US_COUNT_20MHZ) - 1;
+// Applies a queued parameter block right away, used where no zero crossing
+// will come
+static void WAV_Sine_ApplyPending(void){
+    if (sineWave.pending){
+        sineWave.tuningWord = sineWave.next.tuningWord;
+        sineWave.amplitude = sineWave.next.amplitude;
+        sineWave.pending = false;
+    }
+}
+
+
+// Refill from the DMA interrupt, hands over queued parameters at a zero
+// crossing exactly like WAV_Sine_Advance() does in the sample ISR
+static void WAV_Sine_Fill(uint16_t *block, uint_fast16_t count){
+    uint32_t phase = sineWave.phase;
+    uint32_t tuningWord = sineWave.tuningWord;
+    int16_t amplitude = sineWave.amplitude;
+    uint32_t next;
+
+    while (count--){
+        if (sineWave.interpolate){
+            *block++ = SINE_MIDSCALE + WAV_Scale(DDS_QuarterWaveInterp(phase, sineQTable, SINE_QTABLE_SIZE), amplitude);
+        }
+        else {
+            *block++ = SINE_MIDSCALE + WAV_Scale(DDS_QuarterWave(phase, sineQTable, SINE_QTABLE_SIZE), amplitude);
+        }
+        next = phase + tuningWord;
+        if (sineWave.pending && ((next ^ phase) & 0x80000000UL)){               // phase crossed 0 or 180 deg, output is at midscale
+            tuningWord = sineWave.next.tuningWord;
+            amplitude = sineWave.next.amplitude;
+            sineWave.tuningWord = tuningWord;
+            sineWave.amplitude = amplitude;
+            sineWave.pending = false;
+            if (WAV_Sine_UpdateHandler != NULL){
+                WAV_Sine_UpdateHandler();
+            }
+        }
+        phase = next;
+    }
+    sineWave.phase = phase;
+}
+
+
+void WAV_Sine_StreamInit(bool activeOnIdle, bool activeOnSleep, uint_fast16_t freq, uint_fast32_t samplingFreq, uint16_t *buffer, uint_fast16_t length){
+    uint_fast32_t cycles;
+    uint_fast16_t i;
+
+    sineWave.samplingFrequency = WAV_SetSamplingRate(samplingFreq, SCCP8_MIN_PERIOD);
+    sineWave.phase = 0;
+    sineWave.pending = false;
+    sineWave.stream = false;
+    sineWave.fixed = false;
+    sineWave.amplitude = WAV_FULL_SCALE;
+    IEC9bits.CCT8IE = false;
+    WAV_Sine_SetFrequency(freq);
+
+    if ((((uint64_t) freq * length * wavPeriod) % wavClock) == 0){              // buffer holds whole cycles, DMA can loop it forever
+        cycles = ((uint64_t) freq * length * wavPeriod) / wavClock;
+        for (i = 0; i < length; i++){                                           // exact phase per sample so the loop point has no seam
+            buffer[i] = SINE_MIDSCALE + WAV_Scale(DDS_QuarterWave((uint32_t) ((((uint64_t) i * cycles) << 32) / length), sineQTable, SINE_QTABLE_SIZE), sineWave.amplitude);
+        }
+        WAV_Stream_Init(activeOnIdle, activeOnSleep, samplingFreq, buffer, length, NULL);
+        sineWave.fixed = true;                                                  // the DMA replays these samples, nothing to update
+    }
+    else {
+        WAV_Sine_Fill(buffer, length);
+        WAV_Stream_Init(activeOnIdle, activeOnSleep, samplingFreq, buffer, length, WAV_Sine_Fill);
+        sineWave.stream = true;                                                 // later updates go through the refill
+    }
+}
+
+
+void WAV_Stream_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, uint16_t *buffer, uint_fast16_t length, void (* RefillHandler)(uint16_t *block, uint_fast16_t count)){
+    WAV_SetSamplingRate(samplingFreq, SCCP8_MIN_PERIOD);                        // same rounding as DAC_StreamInit(), keeps WAV_GetSamplingFrequency() valid
+    DAC_StreamInit(activeOnIdle, activeOnSleep, samplingFreq, buffer, length, (RefillHandler != NULL) ? DAC_STREAM_CALLBACK : DAC_STREAM_LOOP, RefillHandler);
+}
+
+
+void WAV_Stream_Start(void){
+    DAC_StreamStart();
+}
+
+
+void WAV_Stream_Stop(void){
+    DAC_StreamStop();
+    WAV_Sine_ApplyPending();                                                    // no refill will come
+}
+
+
+void WAV_Sine_Start(void){
+    WAV_Timer_Start();
+}
+
+
+void WAV_Sine_Stop(void){
+    WAV_Timer_Stop();
+    WAV_Sine_ApplyPending();
+}
+
+
+bool WAV_Sine_SetFrequency(uint_fast16_t freq){
+    return WAV_Sine_SetFrequencyMilliHz(freq * DDS_MILLIHZ_PER_HZ);
+}
+
+
+bool WAV_Sine_SetFrequencyMilliHz(uint_fast32_t freq_mHz){
+    if (sineWave.pending){                                                      // keep the amplitude of a block still in flight
+        return WAV_Sine_Update(freq_mHz, sineWave.next.amplitude);
+    }
+    return WAV_Sine_Update(freq_mHz, sineWave.amplitude);
+}
+
+
+bool WAV_Sine_SetAmplitude(int16_t amplitude){
+    return WAV_Sine_Update(sineWave.frequency, amplitude);                      // frequency always holds the latest request
+}
+
+
+bool WAV_Sine_Update(uint_fast32_t freq_mHz, int16_t amplitude){
+    if (sineWave.fixed || ((wavMode == WAV_MODE_SWEEP) && IEC9bits.CCT8IE)){    // no refill to apply it, or a running sweep owns the tuning word
+        return false;
+    }
+    sineWave.pending = false;                                                   // ISR leaves next alone while this is false
+    sineWave.frequency = freq_mHz;
+    sineWave.next.tuningWord = WAV_TuningWord(freq_mHz);
+    sineWave.next.amplitude = amplitude;
+
+    if (IEC9bits.CCT8IE || (sineWave.stream && CCP8CON1Lbits.CCPON)){           // sample ISR or DMA refill running
+        sineWave.pending = true;
+    }
+    else {
+        sineWave.tuningWord = sineWave.next.tuningWord;
+        sineWave.amplitude = sineWave.next.amplitude;
+    }
+    return true;
+}
+
+
+bool WAV_Sine_IsUpdatePending(void){
+    return sineWave.pending;
+}
+
+
+void WAV_Sine_SetUpdateHandler(void (* UpdateHandler)(void)){
+    WAV_Sine_UpdateHandler = UpdateHandler;
+}
+
+
+void WAV_Sine_SetInterpolation(bool enable){
+    sineWave.interpolate = enable;
+    if ((wavMode == WAV_MODE_SINE) || (wavMode == WAV_MODE_SINE_INTERP)){
+        wavMode = enable ? WAV_MODE_SINE_INTERP : WAV_MODE_SINE;
+    }
+}
+
+
+static inline bool WAV_Sine_Advance(void){
+    uint32_t phase = sineWave.phase + sineWave.tuningWord;
+    bool wrapped = (phase < sineWave.phase);
+
+    if (sineWave.pending && ((phase ^ sineWave.phase) & 0x80000000UL)){         // phase crossed 0 or 180 deg, output is at midscale
+        sineWave.tuningWord = sineWave.next.tuningWord;
+        sineWave.amplitude = sineWave.next.amplitude;
+        sineWave.pending = false;
+        if (WAV_Sine_UpdateHandler != NULL){
+            WAV_Sine_UpdateHandler();
+        }
+    }
+    sineWave.phase = phase;
+    return wrapped;
+}
+
+
+uint_fast32_t WAV_Sine_GetFrequencyMilliHz(void){
+    return DDS_FrequencyPeriod(sineWave.tuningWord, wavPeriod, wavClock);
+}
+
+
+void WAV_Arb_Init(bool activeOnIdle, bool activeOnSleep, const uint16_t *table, uint_fast16_t length, uint_fast16_t freq, uint_fast32_t samplingFreq){
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+
+    arbWave.table = table;
+    arbWave.length = length;
+    arbWave.pendingTable = NULL;
+    arbWave.samplingFrequency = WAV_SetSamplingRate(samplingFreq, SCCP8_ISR_MIN_PERIOD);
+    arbWave.phase = 0;
+    WAV_Arb_SetFrequency(freq);
+    wavMode = WAV_MODE_ARB;
+    SCCP8_Init(activeOnIdle, activeOnSleep, wavPeriod, INT_PRIORITY);
+}
+
+
+void WAV_Arb_Start(void){
+    WAV_Timer_Start();
+}
+
+
+void WAV_Arb_Stop(void){
+    WAV_Timer_Stop();
+}
+
+
+void WAV_Arb_SetTable(const uint16_t *table, uint_fast16_t length){
+    arbWave.pendingTable = NULL;                                                // ISR ignores the length while the pointer is NULL
+    arbWave.pendingLength = length;
+    arbWave.pendingTable = table;                                               // single word write, atomic w.r.t. the ISR
+}
+
+
+bool WAV_Arb_IsTablePending(void){
+    return arbWave.pendingTable != NULL;
+}
+
+
+void WAV_Arb_SetFrequency(uint_fast16_t freq){
+    arbWave.tuningWord = WAV_TuningWord(freq * DDS_MILLIHZ_PER_HZ);
+}
+
+
+// exp(x) - 1 for the small x of a log sweep step. powf() - 1.0f loses most of
+// the float mantissa there, 100Hz to 10kHz over 100k updates ended 0.4% off.
+// tanh(x/2) keeps full precision near 0
+static float WAV_Expm1(float x){
+    float t = tanhf(0.5f * x);
+
+    return (2.0f * t) / (1.0f - t);
+}
+
+
+void WAV_Sweep_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t startFreq, uint_fast32_t stopFreq, uint_fast32_t duration_ms, WAV_SweepProfile profile, uint_fast16_t updateInterval, uint_fast32_t samplingFreq, void (* CompleteHandler)(void)){
+    uint64_t samples;
+    float growth;
+
+    WAV_Sine_Init(activeOnIdle, activeOnSleep, 0, samplingFreq);
+
+    if (updateInterval == 0){
+        updateInterval = 1;
+    }
+    samples = ((uint64_t) duration_ms * sineWave.samplingFrequency) / 1000;
+    sweepWave.updates = samples / updateInterval;
+    if (sweepWave.updates == 0){
+        sweepWave.updates = 1;
+    }
+    sweepWave.profile = profile;
+    sweepWave.updateInterval = updateInterval;
+    sweepWave.startWord = WAV_TuningWord(startFreq * DDS_MILLIHZ_PER_HZ);
+    sweepWave.stopWord = WAV_TuningWord(stopFreq * DDS_MILLIHZ_PER_HZ);
+    sweepWave.rising = (sweepWave.stopWord >= sweepWave.startWord);
+
+    if (sweepWave.rising){
+        sweepWave.step = (sweepWave.stopWord - sweepWave.startWord) / sweepWave.updates;
+    }
+    else {
+        sweepWave.step = (sweepWave.startWord - sweepWave.stopWord) / sweepWave.updates;
+    }
+
+    sweepWave.ratio = 0;
+    if ((profile == WAV_SWEEP_LOG) && (startFreq != 0) && (stopFreq != 0)){     // per update growth = (stop / start) ^ (1 / updates)
+        growth = WAV_Expm1(logf((float) stopFreq / (float) startFreq) / (float) sweepWave.updates);
+        sweepWave.ratio = (uint32_t) (fabsf(growth) * 1073741824.0f + 0.5f);
+    }
+    else {
+        sweepWave.profile = WAV_SWEEP_LINEAR;                                   // log sweep cannot start or stop at 0Hz
+    }
+    WAV_Sweep_CompleteHandler = CompleteHandler;
+    sineWave.tuningWord = sweepWave.startWord;
+}
+
+
+void WAV_Sweep_Start(void){
+    IEC9bits.CCT8IE = false;
+    sineWave.phase = 0;
+    sineWave.tuningWord = sweepWave.startWord;
+    sweepWave.updateCounter = sweepWave.updateInterval;
+    sweepWave.remaining = sweepWave.updates;
+    sweepWave.fraction = 0;
+    wavMode = WAV_MODE_SWEEP;
+    WAV_Sine_Start();
+}
+
+
+void WAV_Sweep_Stop(void){
+    WAV_Sine_Stop();
+    if (wavMode == WAV_MODE_SWEEP){                                             // stays on the frequency reached, like a completed sweep
+        wavMode = sineWave.interpolate ? WAV_MODE_SINE_INTERP : WAV_MODE_SINE;
+    }
+}
+
+
+bool WAV_Sweep_IsRunning(void){
+    return (wavMode == WAV_MODE_SWEEP) && CCP8CON1Lbits.CCPON;                  // a burst parks the mode with the timer off
+}
+
+
+static inline void WAV_Sweep_Update(void){
+    uint32_t delta = sweepWave.step;
+
+    if (sweepWave.profile == WAV_SWEEP_LOG){
+        delta = DDS_MulQ30(sineWave.tuningWord, sweepWave.ratio, &sweepWave.fraction);
+    }
+    if (sweepWave.rising){
+        sineWave.tuningWord += delta;
+    }
+    else {
+        sineWave.tuningWord -= delta;
+    }
+
+    if (--sweepWave.remaining == 0){
+        sineWave.tuningWord = sweepWave.stopWord;                               // land exactly on the stop frequency
+        wavMode = sineWave.interpolate ? WAV_MODE_SINE_INTERP : WAV_MODE_SINE;
+        if (WAV_Sweep_CompleteHandler != NULL){
+            WAV_Sweep_CompleteHandler();
+        }
+    }
+}
+
+
+void WAV_MultiTone_Init(bool activeOnIdle, bool activeOnSleep, uint_fast8_t count, uint_fast32_t samplingFreq){
+    uint_fast8_t i;
+
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+    WAV_Cal_Fold();
+
+    if (count > WAV_MAX_TONES){
+        count = WAV_MAX_TONES;
+    }
+    multiTone.count = count;
+    multiTone.samplingFrequency = WAV_SetSamplingRate(samplingFreq, SCCP8_ISR_MIN_PERIOD);
+    for (i = 0; i < WAV_MAX_TONES; i++){
+        multiTone.tone[i].phase = 0;
+        multiTone.tone[i].tuningWord = 0;
+        multiTone.tone[i].amplitude = 0;
+    }
+    wavMode = WAV_MODE_MULTITONE;
+    SCCP8_Init(activeOnIdle, activeOnSleep, wavPeriod, INT_PRIORITY);
+}
+
+
+void WAV_MultiTone_SetTone(uint_fast8_t n, uint_fast32_t freq, int16_t amplitude){
+    if (n >= WAV_MAX_TONES){
+        return;
+    }
+    multiTone.tone[n].tuningWord = WAV_TuningWord(freq * DDS_MILLIHZ_PER_HZ);
+    multiTone.tone[n].amplitude = amplitude;
+}
+
+
+void WAV_MultiTone_Start(void){
+    WAV_Timer_Start();
+}
+
+
+void WAV_MultiTone_Stop(void){
+    WAV_Timer_Stop();
+}
+
+
+void WAV_Mod_Init(bool activeOnIdle, bool activeOnSleep, WAV_ModType type, uint_fast32_t carrierFreq, int16_t amplitude, uint_fast32_t symbolRate, uint_fast32_t samplingFreq){
+    uint_fast32_t rate;
+
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+    WAV_Cal_Fold();
+
+    rate = WAV_SetSamplingRate(samplingFreq, SCCP8_ISR_MIN_PERIOD);
+    if (symbolRate == 0){
+        symbolRate = 1;
+    }
+    modWave.samplesPerSymbol = (rate + (symbolRate / 2)) / symbolRate;
+    if (modWave.samplesPerSymbol == 0){
+        modWave.samplesPerSymbol = 1;
+    }
+    modWave.type = type;
+    modWave.carrierWord = WAV_TuningWord(carrierFreq * DDS_MILLIHZ_PER_HZ);
+    modWave.deviationWord = 0;
+    modWave.amplitude = amplitude;
+    modWave.depth = 0;
+    modWave.phase = 0;
+    modWave.tuningWord = modWave.carrierWord;
+    modWave.envelope = amplitude;
+    modWave.phaseOffset = 0;
+    modWave.symbolCounter = modWave.samplesPerSymbol;
+    modWave.head = 0;
+    modWave.tail = 0;
+    modWave.underruns = 0;
+
+    wavMode = WAV_MODE_MOD;
+    SCCP8_Init(activeOnIdle, activeOnSleep, wavPeriod, INT_PRIORITY);
+}
+
+
+void WAV_Mod_SetDepth(int16_t depth){
+    modWave.depth = depth;                                                      // picked up at the next symbol
+}
+
+
+void WAV_Mod_SetDeviation(uint_fast32_t deviation){
+    modWave.deviationWord = WAV_TuningWord(deviation * DDS_MILLIHZ_PER_HZ);
+}
+
+
+uint_fast16_t WAV_Mod_Write(const int16_t *symbols, uint_fast16_t count){
+    uint16_t head = modWave.head;
+    uint_fast16_t n = 0;
+
+    while ((n < count) && (((head + 1) & (WAV_MOD_QUEUE_SIZE - 1)) != modWave.tail)){
+        modWave.queue[head] = symbols[n++];
+        head = (head + 1) & (WAV_MOD_QUEUE_SIZE - 1);
+        modWave.head = head;                                                    // publish after the slot is written
+    }
+    return n;
+}
+
+
+uint_fast16_t WAV_Mod_GetFree(void){
+    return (modWave.tail - modWave.head - 1) & (WAV_MOD_QUEUE_SIZE - 1);
+}
+
+
+uint32_t WAV_Mod_GetUnderruns(void){
+    return modWave.underruns;
+}
+
+
+void WAV_Mod_Start(void){
+    WAV_Timer_Start();
+}
+
+
+void WAV_Mod_Stop(void){
+    WAV_Timer_Stop();
+}
+
+
+static inline void WAV_Mod_NextSymbol(void){
+    uint16_t tail = modWave.tail;
+    int16_t symbol = 0;
+    int32_t envelope;
+
+    if (tail != modWave.head){
+        symbol = modWave.queue[tail];
+        modWave.tail = (tail + 1) & (WAV_MOD_QUEUE_SIZE - 1);
+    }
+    else {
+        modWave.underruns++;
+    }
+
+    switch ( modWave.type ){
+        case WAV_MOD_AM:
+            envelope = (int32_t) modWave.amplitude + WAV_Scale(WAV_Scale(symbol, modWave.depth), modWave.amplitude);
+            if (envelope > WAV_FULL_SCALE){
+                envelope = WAV_FULL_SCALE;
+            }
+            else if (envelope < 0){
+                envelope = 0;
+            }
+            modWave.envelope = envelope;
             break;
-        case FOSC_50MHZ:
-            val = (interval_us * SCCP_1US_COUNT_50MHZ) - 1;
+        case WAV_MOD_FM:
+            modWave.tuningWord = modWave.carrierWord + DDS_MulQ15(modWave.deviationWord, symbol);
             break;
-        case FOSC_100MHZ:
-            val = (interval_us * SCCP_1US_COUNT_100MHZ) - 1;
+        case WAV_MOD_PSK:
+            modWave.phaseOffset = symbol;
             break;
     }
-    
-    CCP8PRL = (val & 0x0000FFFF);
-    CCP8PRH = ((val & 0xFFFF0000) >> 16);
+}
+
+
+void WAV_Noise_Init(bool activeOnIdle, bool activeOnSleep, bool pink, int16_t amplitude, uint_fast32_t samplingFreq){
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+    WAV_Cal_Fold();
+
+    noiseWave.samplingFrequency = WAV_SetSamplingRate(samplingFreq, SCCP8_ISR_MIN_PERIOD);
+    noiseWave.amplitude = amplitude;
+    WAV_Noise_SetSeed(0);
+    wavMode = pink ? WAV_MODE_PINK : WAV_MODE_NOISE;
+    SCCP8_Init(activeOnIdle, activeOnSleep, wavPeriod, INT_PRIORITY);
+}
+
+
+void WAV_Noise_SetSeed(uint32_t seed){
+    uint_fast8_t i;
+
+    noiseWave.state = (seed != 0) ? seed : WAV_NOISE_SEED;                      // 0 is the one state the LFSR never leaves
+    for (i = 0; i < WAV_PINK_STAGES; i++){
+        noiseWave.pinkState[i] = 0;
+    }
+}
 
+
+void WAV_Noise_SetAmplitude(int16_t amplitude){
+    noiseWave.amplitude = amplitude;
+}
+
+
+void WAV_Noise_Start(void){
+    WAV_Timer_Start();
+}
+
+
+void WAV_Noise_Stop(void){
+    WAV_Timer_Stop();
+}
+
+
+static inline int16_t WAV_Noise_White(void){
+    uint32_t x = noiseWave.state;
+
+    x ^= x << 13;                                                               // xorshift32, a maximal length LFSR
+    x ^= x >> 17;
+    x ^= x << 5;
+    noiseWave.state = x;
+    return (int16_t) (x >> 16);
+}
+
+
+// Sum of one pole lowpass filters y += (w - y) >> k at k = 2, 4, 6, 8, 10,
+// weighted 2, 4, 8, 16, 32 on top of the white sample. Each 2 octaves down
+// one more filter passes, doubling the amplitude, i.e. -3dB/octave. The
+// shifts are rounded, a floor shift would leave a DC offset in the sum.
+static inline int16_t WAV_Noise_Pink(void){
+    int32_t w = WAV_Noise_White();
+    int32_t *y = noiseWave.pinkState;
+    int32_t sum;
+
+    y[0] += (w - y[0] + 2) >> 2;
+    y[1] += (w - y[1] + 8) >> 4;
+    y[2] += (w - y[2] + 32) >> 6;
+    y[3] += (w - y[3] + 128) >> 8;
+    y[4] += (w - y[4] + 512) >> 10;
+    sum = (w + (y[0] << 1) + (y[1] << 2) + (y[2] << 3) + (y[3] << 4) + (y[4] << 5)) >> 3;
+    if (sum > INT16_MAX){
+        sum = INT16_MAX;
+    }
+    else if (sum < INT16_MIN){
+        sum = INT16_MIN;
+    }
+    return (int16_t) sum;
+}
+
+
+static inline void WAV_Noise_Write(int16_t sample){
+    int16_t val = wavMidscale + (int16_t) (__builtin_mulss(WAV_Scale(sample, noiseWave.amplitude), wavMixScale) >> 15);
+
+    if (val < MIN_DAC_VAL){                                                     // same limits as DAC_Write()
+        val = MIN_DAC_VAL;
+    }
+    else if (val > MAX_DAC_VAL){
+        val = MAX_DAC_VAL;
+    }
+    DAC1DATHbits.DACDAT = val;
+}
+
+
+static void WAV_Clip_Rewind(void){
+    clipPlayer.position = 0;
+    clipPlayer.read = clipPlayer.clip->data;
+    clipPlayer.blockPos = 0;
+    clipPlayer.highNibble = false;
+}
+
+
+// Next sample of the clip, false once all samples have been decoded
+static bool WAV_Clip_Decode(int16_t *sample){
+    uint8_t code;
+
+    if (clipPlayer.position >= clipPlayer.clip->samples){
+        if (!clipPlayer.loop){
+            return false;
+        }
+        WAV_Clip_Rewind();
+    }
+    clipPlayer.position++;
+
+    if (clipPlayer.clip->format == WAV_CLIP_PCM8){
+        *sample = (int16_t) (((int16_t) *clipPlayer.read++ - 0x80) << 8);
+        return true;
+    }
+
+    if (clipPlayer.blockPos == 0){                                              // block header, its predictor is the first sample
+        *sample = ADPCM_ReadHeader(&clipPlayer.adpcm, clipPlayer.read);
+        clipPlayer.read += ADPCM_HEADER_SIZE;
+        clipPlayer.blockPos = 2 * (clipPlayer.clip->blockAlign - ADPCM_HEADER_SIZE);
+        clipPlayer.highNibble = false;
+        return true;
+    }
+    code = *clipPlayer.read;
+    if (clipPlayer.highNibble){
+        code >>= 4;
+        clipPlayer.read++;
+    }
+    clipPlayer.highNibble = !clipPlayer.highNibble;
+    clipPlayer.blockPos--;
+    *sample = ADPCM_Decode(&clipPlayer.adpcm, code);
+    return true;
+}
+
+
+void WAV_Clip_Init(bool activeOnIdle, bool activeOnSleep, const WAV_Clip *clip, bool loop){
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+    WAV_Cal_Fold();
+
+    WAV_SetSamplingRate(clip->samplingFrequency, SCCP8_ISR_MIN_PERIOD);
     IEC9bits.CCT8IE = false;
-    IEC9bits.CCP8IE = false;
+    clipPlayer.clip = clip;
+    clipPlayer.loop = loop;
+    clipPlayer.volume = WAV_FULL_SCALE;
+    clipPlayer.done = false;
+    clipPlayer.head = 0;
+    clipPlayer.tail = 0;
+    clipPlayer.underruns = 0;
+    WAV_Clip_Rewind();
+    WAV_Clip_Service();
+
+    wavMode = WAV_MODE_CLIP;
+    SCCP8_Init(activeOnIdle, activeOnSleep, wavPeriod, INT_PRIORITY);
+}
+
+
+bool WAV_Clip_Service(void){
+    uint16_t head = clipPlayer.head;
+    uint_fast8_t n;
+    int16_t sample;
+
+    while (!clipPlayer.done && (((clipPlayer.tail - head - 1) & (WAV_CLIP_BUFFER_SIZE - 1)) >= WAV_CLIP_CHUNK)){
+        for (n = 0; n < WAV_CLIP_CHUNK; n++){
+            if (!WAV_Clip_Decode(&sample)){
+                clipPlayer.done = true;                                         // ISR stops once the buffer is drained
+                break;
+            }
+            clipPlayer.buffer[head] = wavMidscale + (int16_t) (__builtin_mulss(WAV_Scale(sample, clipPlayer.volume), wavMixScale) >> 15);
+            head = (head + 1) & (WAV_CLIP_BUFFER_SIZE - 1);
+        }
+        clipPlayer.head = head;                                                 // publish the whole chunk at once
+    }
+    return !clipPlayer.done || (clipPlayer.tail != clipPlayer.head);
+}
+
+
+void WAV_Clip_SetVolume(int16_t volume){
+    clipPlayer.volume = volume;
+}
+
+
+void WAV_Clip_Start(void){
+    WAV_Timer_Start();
+}
+
+
+void WAV_Clip_Stop(void){
+    WAV_Timer_Stop();
+}
+
+
+uint32_t WAV_Clip_GetUnderruns(void){
+    return clipPlayer.underruns;
+}
+
+
+// Noise and clips have no period, a cycle count would never run out
+static bool WAV_Burst_HasCycles(void){
+    return (wavMode != WAV_MODE_NOISE) && (wavMode != WAV_MODE_PINK) && (wavMode != WAV_MODE_CLIP);
+}
+
+
+bool WAV_Burst_Init(uint_fast32_t count, WAV_BurstUnit unit, void (* CompleteHandler)(void)){
+    if ((unit == WAV_BURST_CYCLES) && !WAV_Burst_HasCycles()){
+        return false;
+    }
+    burstWave.count = count;
+    burstWave.unit = unit;
+    burstWave.remaining = 0;
+    WAV_Burst_CompleteHandler = CompleteHandler;
+    return true;
+}
+
+
+void WAV_Burst_Trigger(void){
+    uint_fast8_t i;
+
+    if (CCP8CON1Lbits.CCPON){                                                   // burst in progress
+        return;
+    }
+    if ((burstWave.unit == WAV_BURST_CYCLES) && !WAV_Burst_HasCycles()){        // mode changed after WAV_Burst_Init()
+        return;
+    }
+    CCP8TMRL = 0x00;                                                            // fixed latency, first sample after one full interval
+    CCP8TMRH = 0x00;
+
+    switch ( wavMode ){
+        case WAV_MODE_ARB:
+            arbWave.phase = 0;
+            break;
+        case WAV_MODE_MOD:
+            modWave.phase = 0;
+            break;
+        case WAV_MODE_MULTITONE:
+            for (i = 0; i < WAV_MAX_TONES; i++){
+                multiTone.tone[i].phase = 0;
+            }
+            break;
+        default:
+            sineWave.phase = 0;
+            break;
+    }
+    burstWave.remaining = burstWave.count;
+    WAV_Timer_Start();
+}
+
+
+bool WAV_Burst_IsRunning(void){
+    return CCP8CON1Lbits.CCPON;
+}
+
+
+void WAV_Burst_SetGatePin(GPIO_Port port, GPIO_Pin pin, GPIO_EdgeType edge){
+    if (port == PORT_A){
+        GPIO_SetPortAPin(pin, INPUT, false, false, false);
+        GPIO_SetPortAInterrupt(pin, edge, WAV_Burst_Trigger);
+    }
+    else {
+        GPIO_SetPortBPin(pin, INPUT, false, false, false);
+        GPIO_SetPortBInterrupt(pin, edge, WAV_Burst_Trigger);
+    }
+}
+
+
+void WAV_Burst_SetGateTimer(uint_fast16_t interval, uint_fast8_t priority){
+    TMR1_SetInterrupt(interval, WAV_Burst_Trigger, priority);
 }
 
 
+static inline void WAV_Burst_Count(bool wrapped){
+    if ((burstWave.unit == WAV_BURST_SAMPLES) || wrapped){
+        if (--burstWave.remaining == 0){
+            burstWave.mode = wavMode;
+            wavMode = WAV_MODE_IDLE;
+        }
+    }
+}
+
+
+// sineQ15QTable sits in the compiler managed auto_psv page. DSRPAG is set once
+// by the startup code and never changed by this library, so the ISR can skip
+// the DSRPAG save/restore that auto_psv would add to every sample. The DAC sine
+// table is read from its calibrated RAM copy.
 void __attribute__ ((interrupt, no_auto_psv)) _CCT8Interrupt (void){
+    register int acc asm("A");
+    WAV_Tone *tone;
+    uint_fast8_t n;
+    int16_t mix;
+    uint32_t phase;
+    uint16_t tail;
+    uint16_t corcon;
+    bool wrapped = false;
+
     IFS9bits.CCT8IF = false;                                                    // clear interrupt flag
+    if ( WAV_ISR_TIMING_EN ){
+        LATBbits.LATB0 = 1;
+    }
 
-    if (sineWave.index > SAMPLE_SIZE){
-        sineWave.index = 1;
+    switch ( wavMode ){
+        case WAV_MODE_ARB:
+            DAC1DATHbits.DACDAT = arbWave.table[DDS_TableIndex(arbWave.phase, arbWave.length)];
+            phase = arbWave.phase + arbWave.tuningWord;
+            wrapped = (phase < arbWave.phase);
+            if (wrapped && (arbWave.pendingTable != NULL)){                     // period boundary, swap in queued table
+                arbWave.length = arbWave.pendingLength;
+                arbWave.table = arbWave.pendingTable;
+                arbWave.pendingTable = NULL;
+            }
+            arbWave.phase = phase;
+            break;
+        case WAV_MODE_SWEEP:
+            DAC1DATHbits.DACDAT = wavMidscale + WAV_Scale(DDS_QuarterWave(sineWave.phase, wavQTable, SINE_QTABLE_SIZE), sineWave.amplitude);
+            phase = sineWave.phase + sineWave.tuningWord;
+            wrapped = (phase < sineWave.phase);
+            sineWave.phase = phase;
+            if (--sweepWave.updateCounter == 0){
+                sweepWave.updateCounter = sweepWave.updateInterval;
+                WAV_Sweep_Update();
+            }
+            break;
+        case WAV_MODE_SINE_INTERP:
+            DAC1DATHbits.DACDAT = wavMidscale + WAV_Scale(DDS_QuarterWaveInterp(sineWave.phase, wavQTable, SINE_QTABLE_SIZE), sineWave.amplitude);
+            wrapped = WAV_Sine_Advance();
+            break;
+        case WAV_MODE_MULTITONE:
+            corcon = CORCON;                                                    // the interrupted code may use the MAC unit in another mode
+            CORCONbits.US = 0;                                                  // signed multiply
+            CORCONbits.SATA = 1;                                                // ACCA saturates instead of wrapping
+            CORCONbits.SATDW = 1;                                               // SAC saturates to 0x8000..0x7FFF
+            CORCONbits.IF = 0;                                                  // fractional multiply, Q15 * Q15 = Q31
+            acc = __builtin_clr();
+            tone = multiTone.tone;
+            phase = tone->phase;
+            for (n = multiTone.count; n != 0; n--){
+                acc = __builtin_mac(acc, DDS_QuarterWave(tone->phase, sineQ15QTable, SINE_QTABLE_SIZE), tone->amplitude, NULL, NULL, 0, NULL, NULL, 0, NULL, 0);
+                tone->phase += tone->tuningWord;
+                tone++;
+            }
+            mix = __builtin_sacr(acc, 0);                                       // saturated to Q15, no compare needed
+            CORCON = corcon;
+            DAC1DATHbits.DACDAT = wavMidscale + (int16_t) (__builtin_mulss(mix, wavMixScale) >> 15);
+            wrapped = (multiTone.tone[0].phase < phase);
+            break;
+        case WAV_MODE_MOD:
+            phase = modWave.phase + ((uint32_t) modWave.phaseOffset << 16);
+            DAC1DATHbits.DACDAT = wavMidscale + WAV_Scale(DDS_QuarterWave(phase, wavQTable, SINE_QTABLE_SIZE), modWave.envelope);
+            phase = modWave.phase + modWave.tuningWord;
+            wrapped = (phase < modWave.phase);                                  // carrier cycles, the PSK offset is left out
+            modWave.phase = phase;
+            if (--modWave.symbolCounter == 0){
+                modWave.symbolCounter = modWave.samplesPerSymbol;
+                WAV_Mod_NextSymbol();
+            }
+            break;
+        case WAV_MODE_NOISE:
+            WAV_Noise_Write(WAV_Noise_White());
+            break;
+        case WAV_MODE_PINK:
+            WAV_Noise_Write(WAV_Noise_Pink());
+            break;
+        case WAV_MODE_CLIP:
+            tail = clipPlayer.tail;
+            if (tail != clipPlayer.head){
+                DAC1DATHbits.DACDAT = clipPlayer.buffer[tail];
+                clipPlayer.tail = (tail + 1) & (WAV_CLIP_BUFFER_SIZE - 1);
+            }
+            else if (clipPlayer.done){                                          // clip played out
+                DAC1DATHbits.DACDAT = wavMidscale;
+                IEC9bits.CCT8IE = false;
+                CCP8CON1Lbits.CCPON = false;
+            }
+            else {
+                clipPlayer.underruns++;                                         // DAC holds the last sample
+            }
+            break;
+        case WAV_MODE_IDLE:
+            DAC1DATHbits.DACDAT = wavMidscale;
+            wavMode = burstWave.mode;
+            IEC9bits.CCT8IE = false;
+            CCP8CON1Lbits.CCPON = false;                                        // stopped here, not from main, so the burst length is exact
+            WAV_Sine_ApplyPending();
+            if (WAV_Burst_CompleteHandler != NULL){
+                WAV_Burst_CompleteHandler();
+            }
+            break;
+        default:
+            DAC1DATHbits.DACDAT = wavMidscale + WAV_Scale(DDS_QuarterWave(sineWave.phase, wavQTable, SINE_QTABLE_SIZE), sineWave.amplitude);
+            wrapped = WAV_Sine_Advance();
+            break;
     }
-    DAC1DATHbits.DACDAT = sineTable[sineWave.index - 1];
-    sineWave.index = sineWave.index + sineWave.stepSize;
-}
 
+    if (burstWave.remaining != 0){
+        WAV_Burst_Count(wrapped);
+    }
 
+    if ( WAV_ISR_TIMING_EN ){
+        LATBbits.LATB0 = 0;
+    }
+}
 
-void WAV_Triangle_Init(bool activeOnIdle){
-    Clock_Freq clk = Sys_GetMasterClkFreq();
 
-    if ((clk != FOSC_8MHZ)) {
-		PMD7bits.CMP1MD = 0;													// enable CMP1 module
+static void WAV_Slope_Init(bool activeOnIdle, uint_fast32_t freq, uint_fast16_t amplitude, bool triangle, bool rising){
+    uint_fast16_t span;
+    uint_fast32_t periodSpan;                                                   // LSB travelled per period
+    uint32_t clock;
+    uint64_t rate;
 
-	    DACCTRL1L = 0x00; 														// CLKDIV 1:1; DACON disabled; DACSIDL disabled; FCLKDIV 1:1; CLKSEL AFVCO/2 - Auxiliary VCO Clock;        
-		DACCTRL1Lbits.DACSIDL = !activeOnIdle;
-	    DACCTRL2L = 0x55; 														// TMODTIME 85; 
-	    DACCTRL2H = 0x8A; 														// SSTIME 138; 
-	    DAC2CONH = 0x00; 														// TMCB 0; 
-	    DAC2CONL = 0x00; 
+    GPIO_SetPortAPin(PIN3, OUTPUT, false, false, false);
+    DAC_Init(activeOnIdle);
+    clock = DAC_GetClkFreq();
 
-	    //Slope Settings
-	    SLP1CONH = 0x00; 														// HME disabled; PSE Negative; SLOPEN disabled; TWME disabled; 
-	    SLP1CONL = 0x00; 														// HCFSEL None; SLPSTRT None; SLPSTOPB None; SLPSTOPA None; 
-	    SLP1DAT = 0x00; 														// SLPDAT 0; 
-	    DAC1DATL = 0x00; 														// DACDATL 0; 
-	    DAC1DATH = 0x00; 														// DACDATH 0; 
-    
-		DAC1CONLbits.DACEN	= 1;												
-		DAC1CONLbits.DACOEN = 1;    											// enable DACOUT pin
+    if (amplitude > (MAX_DAC_VAL - SINE_MIDSCALE)){
+        slopeWave.high = MAX_DAC_VAL;
+    }
+    else {
+        slopeWave.high = SINE_MIDSCALE + amplitude;
+    }
+    if (amplitude > (SINE_MIDSCALE - MIN_DAC_VAL)){
+        slopeWave.low = MIN_DAC_VAL;
+    }
+    else {
+        slopeWave.low = SINE_MIDSCALE - amplitude;
+    }
+    slopeWave.high = DAC_CalApply(slopeWave.high);                              // the slope generator ramps raw codes, fold the correction into its limits
+    slopeWave.low = DAC_CalApply(slopeWave.low);
+    span = (slopeWave.high > slopeWave.low) ? (slopeWave.high - slopeWave.low) : 0;
+    periodSpan = triangle ? (2 * (uint_fast32_t) span) : span;
 
-        DACCTRL1Lbits.DACON = 1;												// enable DAC modules
+    if (periodSpan == 0){                                                       // nothing to ramp, hold a DC level
+        slopeWave.slopeRate = 0;
+        slopeWave.frequency = 0;
+        SLP1CONH = 0x00;
+        SLP1CONL = 0x00;
+        DAC1DATH = slopeWave.high;
+        return;
+    }
+
+    // SLPDAT = LSB per second / DAC clock, in 12.4 fixed point
+    rate = ((((uint64_t) periodSpan * freq) << DAC_SLP_FRAC_BITS) + (clock / 2)) / clock;
+    if (rate < 1){
+        rate = 1;
+    }
+    else if (rate > 0xFFFF){
+        rate = 0xFFFF;
     }
+    slopeWave.slopeRate = rate;
+    slopeWave.frequency = (((uint64_t) clock * rate) >> DAC_SLP_FRAC_BITS) / periodSpan;
+
+    DAC1CONLbits.DACEN = 0;                                                     // hold DAC while the slope generator is set up
+    SLP1CONH = 0x00;                                                            // SLOPEN disabled until WAV_Slope_Start()
+    SLP1CONL = 0x00;                                                            // HCFSEL None; SLPSTRT None; SLPSTOPB None; SLPSTOPA None;
+    SLP1CONHbits.HME = 1;                                                       // hysteretic mode, ramp between DACDATH and DACDATL
+    SLP1CONHbits.TWME = triangle;                                               // triangle: reverse at each limit, sawtooth: restart
+    SLP1CONHbits.PSE = rising;
+    SLP1DAT = slopeWave.slopeRate;
+    DAC1DATH = slopeWave.high;
+    DAC1DATL = slopeWave.low;
+    DAC1CONLbits.DACEN = 1;
+}
+
+
+void WAV_Triangle_Init(bool activeOnIdle, uint_fast32_t freq, uint_fast16_t amplitude){
+    WAV_Slope_Init(activeOnIdle, freq, amplitude, true, true);
+}
+
+
+void WAV_Sawtooth_Init(bool activeOnIdle, uint_fast32_t freq, uint_fast16_t amplitude, bool rising){
+    WAV_Slope_Init(activeOnIdle, freq, amplitude, false, rising);
+}
+
+
+void WAV_Slope_Start(void){
+    SLP1CONHbits.SLOPEN = (slopeWave.slopeRate != 0);                           // stays off for a DC level
+}
+
+
+void WAV_Slope_Stop(void){
+    SLP1CONHbits.SLOPEN = 0;
+}
+
+
+uint_fast32_t WAV_Slope_GetFrequency(void){
+    return slopeWave.frequency;
 }
@@ -18,24 +18,209 @@
 
 
 #include "nanolay.h"
+#include "nanolay_dds.h"
+#include "nanolay_adpcm.h"
 
 
-#define SAMPLE_SIZE     1600                                                    // 1600 samples in the lookup table
+// Table parameters. nanolay_wavtables.c is generated from these, run
+// python3 tools/gen_wavtables.py after changing any of them
+#define SAMPLE_SIZE     1600                                                    // samples per cycle, must be a multiple of 4
+#define WAV_TABLE_BITS  12                                                      // table resolution, 12 = full DAC resolution
+#define SINE_AMPLITUDE  1842                                                    // sine peak in DAC LSB
+#define SINE_MIDSCALE   0x0800                                                  // DAC value at zero phase
+
+#define SINE_QTABLE_SIZE    (SAMPLE_SIZE / 4)                                   // only the first quadrant is stored
 #define INT_PRIORITY    2
+#define WAV_RATE_SEARCH 256                                                     // periods tried by WAV_BestSamplingFrequency()
+#define WAV_MAX_TONES   4
+#define WAV_FULL_SCALE  0x7FFF                                                  // Q15 amplitude of a full DAC swing
+#define WAV_MIX_SCALE   (MAX_DAC_VAL - SINE_MIDSCALE)                           // Q15 full scale maps onto MIN_DAC_VAL..MAX_DAC_VAL
+#define WAV_MOD_QUEUE_SIZE  64                                                  // symbols, must be a power of 2
+#define WAV_NOISE_SEED  0x92D68CA2UL                                            // any non-zero value
+#define WAV_PINK_STAGES 5                                                       // one pole per 2 octaves
+#define WAV_CLIP_BUFFER_SIZE    256                                             // decoded samples, must be a power of 2
+#define WAV_CLIP_CHUNK  32                                                      // samples decoded per step of WAV_Clip_Service()
+#define WAV_ISR_TIMING_EN   false                                               // debug only, RB0 is high while the sample ISR runs
+
+
+extern const int16_t __attribute__((space(auto_psv))) sineQTable[SINE_QTABLE_SIZE + 1];
+extern const int16_t __attribute__((space(auto_psv))) sineQ15QTable[SINE_QTABLE_SIZE + 1];
+
+
+typedef enum wav_mode {
+    WAV_MODE_SINE = 0,
+    WAV_MODE_ARB = 1,
+    WAV_MODE_SWEEP = 2,
+    WAV_MODE_MULTITONE = 3,
+    WAV_MODE_SINE_INTERP = 4,
+    WAV_MODE_IDLE = 5,                                                          // burst ended, next tick parks the output at midscale
+    WAV_MODE_MOD = 6,
+    WAV_MODE_NOISE = 7,
+    WAV_MODE_PINK = 8,
+    WAV_MODE_CLIP = 9
+} WAV_Mode;
+
+
+typedef enum wav_clip_format {
+    WAV_CLIP_PCM8 = 0,                                                          // unsigned 8bit, 0x80 = midscale
+    WAV_CLIP_IMA_ADPCM = 1                                                      // 4bit IMA-ADPCM blocks, WAV format 0x0011 layout
+} WAV_ClipFormat;
+
+
+typedef enum wav_mod_type {
+    WAV_MOD_AM = 0,                                                             // symbol = Q15 modulating sample
+    WAV_MOD_FM = 1,                                                             // symbol = Q15 modulating sample
+    WAV_MOD_PSK = 2                                                             // symbol = carrier phase, 0x10000 = 360 deg
+} WAV_ModType;
+
+
+typedef enum wav_burst_unit {
+    WAV_BURST_SAMPLES = 0,
+    WAV_BURST_CYCLES = 1                                                        // phase accumulator wraps, tone 0 in multi-tone mode, carrier in mod mode
+} WAV_BurstUnit;
+
+
+typedef enum wav_sweep_profile {
+    WAV_SWEEP_LINEAR = 0,                                                       // constant Hz per second
+    WAV_SWEEP_LOG = 1                                                           // constant octaves per second
+} WAV_SweepProfile;
+
+
+typedef struct sine_params {
+    uint32_t            tuningWord;
+    int16_t             amplitude;
+} WAV_SineParams;
 
 
 typedef struct sine_waveform {
-    uint_fast16_t       frequency;
-    uint_fast8_t        samplingInterval;
-    uint_fast32_t       samplingFrequency;
-    uint_fast16_t       index;
-    uint_fast8_t        stepSize;
+    uint_fast32_t       frequency;                                              // requested frequency in mHz
+    uint_fast32_t       samplingFrequency;                                      // actual sampling frequency in Hz
+    uint32_t            phase;                                                  // DDS phase accumulator, 2^32 = one full cycle
+    uint32_t            tuningWord;                                             // DDS phase increment per sample
+    int16_t             amplitude;                                              // Q15, 0x7FFF = full DAC swing
+    bool                interpolate;                                            // linear interpolation between table entries
+    bool                stream;                                                 // true = refilled from the DMA interrupt
+    bool                fixed;                                                  // true = DMA loops a prefilled buffer, no updates
+    WAV_SineParams      next;                                                   // queued parameters, owned by main while pending is false
+    volatile bool       pending;                                                // true = ISR swaps next in at the next zero crossing
 } WAV_Sine;
 
 
+typedef struct sweep_waveform {
+    WAV_SweepProfile        profile;
+    uint32_t                startWord;                                          // tuning word at start frequency
+    uint32_t                stopWord;                                           // tuning word at stop frequency
+    uint32_t                step;                                               // linear: tuning word change per update
+    uint32_t                ratio;                                              // log: |growth - 1| per update, Q2.30
+    uint32_t                fraction;                                           // log: Q2.30 bits of the last delta not applied yet
+    bool                    rising;
+    uint_fast16_t           updateInterval;                                     // samples per tuning word update
+    volatile uint_fast16_t  updateCounter;
+    uint32_t                updates;                                            // tuning word updates per sweep
+    volatile uint32_t       remaining;
+} WAV_Sweep;
+
+
+typedef struct tone {
+    uint32_t            phase;                                                  // DDS phase accumulator
+    uint32_t            tuningWord;
+    int16_t             amplitude;                                              // Q15, 0x7FFF = full DAC swing
+} WAV_Tone;
+
+
+typedef struct multitone_waveform {
+    WAV_Tone            tone[WAV_MAX_TONES];
+    uint_fast8_t        count;                                                  // tones mixed per sample
+    uint_fast32_t       samplingFrequency;                                      // actual sampling frequency in Hz
+} WAV_MultiTone;
+
+
+typedef struct slope_waveform {
+    uint_fast32_t       frequency;                                              // actual frequency in Hz
+    uint_fast16_t       high;                                                   // upper limit, DAC1DATH
+    uint_fast16_t       low;                                                    // lower limit, DAC1DATL
+    uint_fast16_t       slopeRate;                                              // SLP1DAT, 12.4 LSB per DAC clock
+} WAV_Slope;
+
+
+typedef struct arb_waveform {
+    const uint16_t                  *table;                                     // DAC values of one period
+    uint16_t                        length;
+    const uint16_t * volatile       pendingTable;                               // swapped in by the ISR at the next period boundary
+    volatile uint16_t               pendingLength;
+    uint_fast32_t                   samplingFrequency;                          // actual sampling frequency in Hz
+    uint32_t                        phase;                                      // DDS phase accumulator, 2^32 = one table period
+    uint32_t                        tuningWord;
+} WAV_Arb;
+
+
+typedef struct burst_waveform {
+    uint32_t            count;                                                  // samples or cycles per burst, 0 = continuous
+    WAV_BurstUnit       unit;
+    volatile uint32_t   remaining;                                              // counted down by the ISR, 0 = not counting
+    WAV_Mode            mode;                                                   // mode restored after the output is parked
+} WAV_Burst;
+
+
+typedef struct mod_waveform {
+    WAV_ModType             type;
+    uint32_t                carrierWord;                                        // tuning word of the carrier
+    uint32_t                deviationWord;                                      // FM: tuning word of the peak deviation
+    int16_t                 amplitude;                                          // Q15 carrier amplitude
+    int16_t                 depth;                                              // AM: Q15 modulation index
+    uint32_t                phase;                                              // DDS phase accumulator
+    uint32_t                tuningWord;                                         // carrier plus FM deviation of the current symbol
+    int16_t                 envelope;                                           // Q15 amplitude of the current symbol
+    uint16_t                phaseOffset;                                        // PSK phase of the current symbol
+    uint_fast16_t           samplesPerSymbol;
+    volatile uint_fast16_t  symbolCounter;
+    volatile int16_t        queue[WAV_MOD_QUEUE_SIZE];
+    volatile uint16_t       head;                                               // next free slot, written by main only
+    volatile uint16_t       tail;                                               // next symbol, written by the ISR only
+    volatile uint32_t       underruns;                                          // symbol periods with an empty queue
+} WAV_Mod;
+
+
+typedef struct noise_waveform {
+    uint32_t            state;                                                  // xorshift LFSR state, never 0
+    int32_t             pinkState[WAV_PINK_STAGES];                             // one pole lowpass outputs
+    int16_t             amplitude;                                              // Q15, 0x7FFF = full DAC swing
+    uint_fast32_t       samplingFrequency;                                      // actual sampling frequency in Hz
+} WAV_Noise;
+
+
+// Clip stored in program memory, generated by tools/wav2clip.py
+typedef struct wav_clip {
+    const uint8_t       *data;
+    uint32_t            samples;                                                // samples in the clip
+    uint16_t            blockAlign;                                             // ADPCM bytes per block including the header
+    WAV_ClipFormat      format;
+    uint32_t            samplingFrequency;                                      // Hz
+} WAV_Clip;
+
+
+typedef struct clip_player {
+    const WAV_Clip      *clip;
+    bool                loop;
+    int16_t             volume;                                                 // Q15, 0x7FFF = full DAC swing
+    uint32_t            position;                                               // samples decoded so far
+    const uint8_t       *read;                                                  // next byte to decode
+    uint16_t            blockPos;                                               // ADPCM samples left in the current block
+    bool                highNibble;
+    ADPCM_State         adpcm;
+    volatile bool       done;                                                   // decoder reached the end, set by main
+    volatile uint16_t   buffer[WAV_CLIP_BUFFER_SIZE];                           // DAC values ready for the ISR
+    volatile uint16_t   head;                                                   // written by main only
+    volatile uint16_t   tail;                                                   // written by the ISR only
+    volatile uint32_t   underruns;                                              // sample ticks that found the buffer empty
+} WAV_ClipPlayer;
+
+
 // *****************************************************************************
 // @desc:       Initialize Sine wave generator. Output at pin at PA3/RA3/AN3.
 //                  Works only at Fosc = 20MHz and above. Uses SCCP8 as timer.
+//                  Samples are produced by a 32bit phase accumulator (DDS) so
+//                  any frequency below samplingFreq/2 can be generated
 // @args:       activeOnIdle [bool]: true = active on idle
 //              activeOnSleep [bool]: true = active on sleep
 //              freq [uint_fast16_t]: frequency in Hz (works up to 5kHz)
@@ -62,23 +247,674 @@ void WAV_Sine_Stop(void);
 
 
 // *****************************************************************************
-// @desc:       Sets the sine wave frequency
+// @desc:       Sets the sine wave frequency. While running, the change is
+//                  queued and applied at the next zero crossing, see
+//                  WAV_Sine_Update()
 // @args:       freq [uint_fast16_t]: Frequency in Hz (works up to 5kHz)
+// @returns:    [bool]: false = rejected, see WAV_Sine_Update()
+// *****************************************************************************
+bool WAV_Sine_SetFrequency(uint_fast16_t freq);
+
+
+// *****************************************************************************
+// @desc:       Sets the sine wave frequency with sub-Hz resolution. Resolution
+//                  is samplingFreq / 2^32, e.g. 23uHz at 100kHz sampling.
+//                  While running, the change is queued like WAV_Sine_Update()
+// @args:       freq_mHz [uint_fast32_t]: Frequency in mHz
+// @returns:    [bool]: false = rejected, see WAV_Sine_Update()
+// *****************************************************************************
+bool WAV_Sine_SetFrequencyMilliHz(uint_fast32_t freq_mHz);
+
+
+// *****************************************************************************
+// @desc:       Sets the sine wave amplitude. While running, the change is
+//                  queued like WAV_Sine_Update()
+// @args:       amplitude [int16_t]: Q15 amplitude, 0x7FFF = full DAC swing
+// @returns:    [bool]: false = rejected, see WAV_Sine_Update()
+// *****************************************************************************
+bool WAV_Sine_SetAmplitude(int16_t amplitude);
+
+
+// *****************************************************************************
+// @desc:       Queues a new frequency and amplitude as one parameter block.
+//                  The sample ISR, or the DMA refill of WAV_Sine_StreamInit(),
+//                  swaps the whole block in at the next zero crossing of the
+//                  output, without resetting the phase, so frequency hops are
+//                  phase continuous and amplitude steps happen at 0V. A block
+//                  still pending is replaced. If the generator is stopped the
+//                  block is applied immediately. Rejected while a sweep owns
+//                  the frequency and when WAV_Sine_StreamInit() chose its
+//                  looped buffer, whose samples are computed once
+// @args:       freq_mHz [uint_fast32_t]: Frequency in mHz
+//              amplitude [int16_t]: Q15 amplitude, 0x7FFF = full DAC swing
+// @returns:    [bool]: false = rejected, nothing is queued
+// *****************************************************************************
+bool WAV_Sine_Update(uint_fast32_t freq_mHz, int16_t amplitude);
+
+
+// *****************************************************************************
+// @desc:       Checks if a queued parameter block is waiting for the next
+//                  zero crossing
+// @args:       None
+// @returns:    [bool]: true = update pending
+// *****************************************************************************
+bool WAV_Sine_IsUpdatePending(void);
+
+
+// *****************************************************************************
+// @desc:       Assigns a user defined function called from the sample ISR right
+//                  after a queued parameter block has been applied
+// @args:       UpdateHandler [func pointer]: User defined callback, NULL = none
+// @returns:    None
+// *****************************************************************************
+void WAV_Sine_SetUpdateHandler(void (* UpdateHandler)(void));
+
+
+// *****************************************************************************
+// @desc:       Enables linear interpolation between adjacent table entries.
+//                  Removes the staircase at high output frequencies at the
+//                  cost of one multiply per sample. At low frequencies both
+//                  are limited by the 12bit DAC. Also applies to the sine
+//                  DMA stream refill. Persists across WAV_Sine_Init().
+//                  'make -C tools/host quality' reports THD/SFDR with and
+//                  without it for a given table size
+// @args:       enable [bool]: true = interpolate
+// @returns:    None
+// *****************************************************************************
+void WAV_Sine_SetInterpolation(bool enable);
+
+
+// *****************************************************************************
+// @desc:       Returns the frequency actually produced by the DDS engine, which
+//                  may differ from the requested one by up to half a tuning
+//                  word LSB
+// @args:       None
+// @returns:    [uint_fast32_t]: output frequency in mHz
+// *****************************************************************************
+uint_fast32_t WAV_Sine_GetFrequencyMilliHz(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize arbitrary waveform generator. Output at pin at
+//                  PA3/RA3/AN3. Uses SCCP8 as timer. The table is stepped by a
+//                  32bit phase accumulator, so it may have any length and is
+//                  resampled to the requested period. The table may be in RAM
+//                  or a const array in program memory (read through PSV)
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              table [const uint16_t *]: DAC values of one period, each from
+//                  MIN_DAC_VAL to MAX_DAC_VAL. Written to DAC1 as they are, so
+//                  pass each value through DAC_CalApply() for a calibrated
+//                  output. Must stay valid while in use
+//              length [uint_fast16_t]: number of entries in table
+//              freq [uint_fast16_t]: table repetitions per second, in Hz
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+// @returns:    None
+// *****************************************************************************
+void WAV_Arb_Init(bool activeOnIdle, bool activeOnSleep, const uint16_t *table, uint_fast16_t length, uint_fast16_t freq, uint_fast32_t samplingFreq);
+
+
+// *****************************************************************************
+// @desc:       Starts the arbitrary waveform output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Arb_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the arbitrary waveform output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Arb_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Queues a new table. The ISR switches to it when the current
+//                  period ends, so the output never mixes two tables within
+//                  one period. A table still pending is replaced
+// @args:       table [const uint16_t *]: DAC values of one period
+//              length [uint_fast16_t]: number of entries in table
+// @returns:    None
+// *****************************************************************************
+void WAV_Arb_SetTable(const uint16_t *table, uint_fast16_t length);
+
+
+// *****************************************************************************
+// @desc:       Checks if a table queued by WAV_Arb_SetTable() is still waiting
+//                  for the period boundary. The old table must not be
+//                  modified or freed until this returns false
+// @args:       None
+// @returns:    [bool]: true = switch still pending
+// *****************************************************************************
+bool WAV_Arb_IsTablePending(void);
+
+
+// *****************************************************************************
+// @desc:       Sets the table repetition frequency
+// @args:       freq [uint_fast16_t]: Frequency in Hz
+// @returns:    None
+// *****************************************************************************
+void WAV_Arb_SetFrequency(uint_fast16_t freq);
+
+
+// *****************************************************************************
+// @desc:       Initialize sine frequency sweep (chirp). Output at pin at
+//                  PA3/RA3/AN3. Uses SCCP8 as timer. The DDS tuning word is
+//                  updated inside the sample ISR every updateInterval samples,
+//                  so the output is phase continuous with no stair-steps from
+//                  main context. At the end the tone holds at stopFreq
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              startFreq [uint_fast32_t]: start frequency in Hz
+//              stopFreq [uint_fast32_t]: stop frequency in Hz, may be lower
+//                  than startFreq for a down sweep
+//              duration_ms [uint_fast32_t]: sweep duration in ms
+//              profile [WAV_SweepProfile]: WAV_SWEEP_LINEAR or WAV_SWEEP_LOG
+//              updateInterval [uint_fast16_t]: samples between tuning word
+//                  updates, 1 = every sample
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+//              CompleteHandler [func pointer]: called from the ISR when the
+//                  sweep ends, NULL = none
+// @returns:    None
+// *****************************************************************************
+void WAV_Sweep_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t startFreq, uint_fast32_t stopFreq, uint_fast32_t duration_ms, WAV_SweepProfile profile, uint_fast16_t updateInterval, uint_fast32_t samplingFreq, void (* CompleteHandler)(void));
+
+
+// *****************************************************************************
+// @desc:       Starts (or restarts) the sweep from startFreq
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Sweep_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the sweep output at pin RA3. The generator is left as a
+//                  plain sine at the frequency reached, WAV_Sweep_IsRunning()
+//                  returns false
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Sweep_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Checks if a sweep is in progress
+// @args:       None
+// @returns:    [bool]: true = still sweeping, false once completed or stopped
+// *****************************************************************************
+bool WAV_Sweep_IsRunning(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize multi-tone generator. Output at pin at PA3/RA3/AN3.
+//                  Uses SCCP8 as timer. Up to WAV_MAX_TONES sines, each with
+//                  its own phase accumulator and Q15 amplitude, are summed in
+//                  the DSP accumulator (MAC) and saturated to Q15, so the
+//                  output never leaves MIN_DAC_VAL..MAX_DAC_VAL even when the
+//                  amplitudes add up to more than 1.0.
+//                  The ISR cost grows with count and has not been measured.
+//                  Set WAV_ISR_TIMING_EN, measure the high time on RB0 and
+//                  keep it well below 1 / samplingFreq
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              count [uint_fast8_t]: number of tones, 1 to WAV_MAX_TONES
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+// @returns:    None
+// *****************************************************************************
+void WAV_MultiTone_Init(bool activeOnIdle, bool activeOnSleep, uint_fast8_t count, uint_fast32_t samplingFreq);
+
+
+// *****************************************************************************
+// @desc:       Sets frequency and amplitude of one tone
+// @args:       n [uint_fast8_t]: tone index, 0 to count - 1
+//              freq [uint_fast32_t]: frequency in Hz
+//              amplitude [int16_t]: Q15 amplitude, 0x7FFF = full DAC swing
+// @returns:    None
+// *****************************************************************************
+void WAV_MultiTone_SetTone(uint_fast8_t n, uint_fast32_t freq, int16_t amplitude);
+
+
+// *****************************************************************************
+// @desc:       Starts the multi-tone output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_MultiTone_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the multi-tone output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_MultiTone_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize triangle wave generator on the DAC1 slope generator
+//                  (triangle wave mode). Output at pin PA3/RA3/AN3. Runs in the
+//                  analog peripheral only, no timer or interrupt is used.
+//                  Works only at Fosc = 20MHz and above
+// @args:       activeOnIdle [bool]: true = active on idle
+//              freq [uint_fast32_t]: frequency in Hz. The slope rate has 1/16
+//                  LSB per DAC clock resolution, so low frequencies with large
+//                  amplitudes are limited, see WAV_Slope_GetFrequency()
+//              amplitude [uint_fast16_t]: peak deviation from midscale in DAC
+//                  LSB, limited to MIN_DAC_VAL/MAX_DAC_VAL. 0 holds midscale
+//                  and WAV_Slope_GetFrequency() returns 0
+// @returns:    None
+// *****************************************************************************
+void WAV_Triangle_Init(bool activeOnIdle, uint_fast32_t freq, uint_fast16_t amplitude);
+
+
+// *****************************************************************************
+// @desc:       Initialize sawtooth wave generator on the DAC1 slope generator
+//                  (hysteretic mode). The ramp runs from one limit to the other
+//                  and restarts. Output at pin PA3/RA3/AN3. Runs in the analog
+//                  peripheral only, no timer or interrupt is used.
+//                  Works only at Fosc = 20MHz and above
+// @args:       activeOnIdle [bool]: true = active on idle
+//              freq [uint_fast32_t]: frequency in Hz
+//              amplitude [uint_fast16_t]: peak deviation from midscale in DAC
+//                  LSB, limited to MIN_DAC_VAL/MAX_DAC_VAL. 0 holds midscale
+//              rising [bool]: true = positive ramp, false = negative ramp
+// @returns:    None
+// *****************************************************************************
+void WAV_Sawtooth_Init(bool activeOnIdle, uint_fast32_t freq, uint_fast16_t amplitude, bool rising);
+
+
+// *****************************************************************************
+// @desc:       Starts the triangle/sawtooth output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Slope_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the triangle/sawtooth output at pin RA3. Output holds the
+//                  upper limit
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Slope_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the triangle/sawtooth frequency actually produced after
+//                  rounding of the slope rate
+// @args:       None
+// @returns:    [uint_fast32_t]: frequency in Hz
+// *****************************************************************************
+uint_fast32_t WAV_Slope_GetFrequency(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize the modulator. Output at pin PA3/RA3/AN3. Uses SCCP8
+//                  as timer. A sine carrier is modulated by symbols taken from
+//                  a queue once every symbol period. All per symbol math is
+//                  fixed point and done in the sample ISR at the symbol
+//                  boundary, so the per sample cost is close to the plain
+//                  sine mode. Symbol meaning depends on type:
+//                  AM: Q15 sample m, amplitude = carrier * (1 + depth * m)
+//                  FM: Q15 sample m, frequency = carrier + deviation * m,
+//                      phase continuous. +-0x7FFF gives 2-FSK
+//                  PSK: carrier phase, 0x10000 = 360 deg. BPSK uses 0 and
+//                      0x8000, QPSK 0, 0x4000, 0x8000 and 0xC000
+//                  When the queue runs empty symbol 0 is sent, i.e. the plain
+//                  carrier for AM/FM and phase 0 for PSK
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              type [WAV_ModType]: WAV_MOD_AM, WAV_MOD_FM or WAV_MOD_PSK
+//              carrierFreq [uint_fast32_t]: carrier frequency in Hz
+//              amplitude [int16_t]: Q15 carrier amplitude, 0x7FFF = full DAC
+//                  swing. For AM keep amplitude * (1 + depth) below 1.0
+//              symbolRate [uint_fast32_t]: symbols per second, rounded to a
+//                  whole number of samples per symbol
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+// @returns:    None
+// *****************************************************************************
+void WAV_Mod_Init(bool activeOnIdle, bool activeOnSleep, WAV_ModType type, uint_fast32_t carrierFreq, int16_t amplitude, uint_fast32_t symbolRate, uint_fast32_t samplingFreq);
+
+
+// *****************************************************************************
+// @desc:       Sets the AM modulation index
+// @args:       depth [int16_t]: Q15 modulation index, 0x7FFF = 100%
+// @returns:    None
+// *****************************************************************************
+void WAV_Mod_SetDepth(int16_t depth);
+
+
+// *****************************************************************************
+// @desc:       Sets the FM peak deviation, reached at symbol +-0x7FFF
+// @args:       deviation [uint_fast32_t]: peak deviation in Hz
+// @returns:    None
+// *****************************************************************************
+void WAV_Mod_SetDeviation(uint_fast32_t deviation);
+
+
+// *****************************************************************************
+// @desc:       Queues symbols without blocking. The queue is a single producer
+//                  single consumer ring, main writes the head and the ISR the
+//                  tail, so the carrier keeps running while it is fed. Must
+//                  only be called from one context
+// @args:       symbols [const int16_t *]: symbols, see WAV_Mod_Init()
+//              count [uint_fast16_t]: number of symbols
+// @returns:    [uint_fast16_t]: number of symbols actually queued
+// *****************************************************************************
+uint_fast16_t WAV_Mod_Write(const int16_t *symbols, uint_fast16_t count);
+
+
+// *****************************************************************************
+// @desc:       Returns the free space in the symbol queue
+// @args:       None
+// @returns:    [uint_fast16_t]: number of symbols that can be queued
+// *****************************************************************************
+uint_fast16_t WAV_Mod_GetFree(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the number of symbol periods that found the queue empty
+//                  since WAV_Mod_Init()
+// @args:       None
+// @returns:    [uint32_t]: underrun count
+// *****************************************************************************
+uint32_t WAV_Mod_GetUnderruns(void);
+
+
+// *****************************************************************************
+// @desc:       Starts the modulated output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Mod_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the modulated output at pin RA3. Queued symbols are kept
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Mod_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize noise generator. Output at pin PA3/RA3/AN3. Uses
+//                  SCCP8 as timer. White noise comes from a 32bit xorshift
+//                  LFSR (period 2^32 - 1), uniform over the full Q15 range.
+//                  Pink noise feeds it through 5 one pole lowpass filters
+//                  spaced 2 octaves apart, built from shifts and adds only,
+//                  giving -3dB/octave +-0.5dB from Fs/16 down to Fs/2048.
+//                  Pink output is about 0.25 of full scale RMS and saturates
+//                  on rare peaks. Samples are clamped to MIN_DAC_VAL and
+//                  MAX_DAC_VAL like DAC_Write(). There are no loops, so the
+//                  ISR cost is the same for every sample. It has not been
+//                  measured, set WAV_ISR_TIMING_EN to see it on RB0
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              pink [bool]: true = pink, false = white
+//              amplitude [int16_t]: Q15 amplitude, 0x7FFF = full DAC swing
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+// @returns:    None
+// *****************************************************************************
+void WAV_Noise_Init(bool activeOnIdle, bool activeOnSleep, bool pink, int16_t amplitude, uint_fast32_t samplingFreq);
+
+
+// *****************************************************************************
+// @desc:       Restarts the noise sequence from a seed, so a stimulus can be
+//                  repeated exactly. Also clears the pink filter
+// @args:       seed [uint32_t]: LFSR seed, 0 = WAV_NOISE_SEED
+// @returns:    None
+// *****************************************************************************
+void WAV_Noise_SetSeed(uint32_t seed);
+
+
+// *****************************************************************************
+// @desc:       Sets the noise amplitude
+// @args:       amplitude [int16_t]: Q15 amplitude, 0x7FFF = full DAC swing
+// @returns:    None
+// *****************************************************************************
+void WAV_Noise_SetAmplitude(int16_t amplitude);
+
+
+// *****************************************************************************
+// @desc:       Starts the noise output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Noise_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the noise output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Noise_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize clip playback from program memory. Output at pin
+//                  PA3/RA3/AN3. Uses SCCP8 as timer at the clip's sampling
+//                  frequency. Clips are decoded in chunks of WAV_CLIP_CHUNK
+//                  samples by WAV_Clip_Service() in main context into a ring
+//                  buffer of DAC values, and the sample ISR only pops one
+//                  value per tick, so its cost does not depend on the format.
+//                  The buffer is filled before returning
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              clip [const WAV_Clip *]: clip made by tools/wav2clip.py, must
+//                  stay valid while playing
+//              loop [bool]: true = restart at the end, false = play once
 // @returns:    None
 // *****************************************************************************
-void WAV_Sine_SetFrequency(uint_fast16_t freq);
+void WAV_Clip_Init(bool activeOnIdle, bool activeOnSleep, const WAV_Clip *clip, bool loop);
 
 
 // *****************************************************************************
-// @desc:       Initializes the SCCP8 module and used as a 32bit timer with 1us
-//                  resolution
+// @desc:       Decodes into the free part of the ring buffer. Call from the
+//                  main loop at least once every
+//                  (WAV_CLIP_BUFFER_SIZE - WAV_CLIP_CHUNK) sample periods,
+//                  e.g. every 28ms at 8kHz, or the output underruns
+// @args:       None
+// @returns:    [bool]: true = clip still playing
+// *****************************************************************************
+bool WAV_Clip_Service(void);
+
+
+// *****************************************************************************
+// @desc:       Sets the playback volume. Applies to samples decoded after the
+//                  call, up to WAV_CLIP_BUFFER_SIZE samples later
+// @args:       volume [int16_t]: Q15 volume, 0x7FFF = full DAC swing
+// @returns:    None
+// *****************************************************************************
+void WAV_Clip_SetVolume(int16_t volume);
+
+
+// *****************************************************************************
+// @desc:       Starts the clip output at pin RA3. At the end of a clip played
+//                  once the output returns to midscale and SCCP8 stops, call
+//                  WAV_Clip_Init() again to replay it
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Clip_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the clip output at pin RA3. WAV_Clip_Start() resumes
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Clip_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the number of sample ticks that found the ring buffer
+//                  empty, i.e. WAV_Clip_Service() was called too rarely
+// @args:       None
+// @returns:    [uint32_t]: underrun count
+// *****************************************************************************
+uint32_t WAV_Clip_GetUnderruns(void);
+
+
+// *****************************************************************************
+// @desc:       Configures burst output for the sample ISR generators. Call
+//                  after the generator's Init function. Each trigger restarts
+//                  the waveform at phase 0 and the sample ISR counts the
+//                  output itself. After the last sample or cycle the DAC is
+//                  set to midscale on the next sample tick and SCCP8 is
+//                  switched off from within the ISR, so the burst length is
+//                  exact to the sample
+// @args:       count [uint_fast32_t]: samples or cycles per burst, 0 = output
+//                  runs until stopped
+//              unit [WAV_BurstUnit]: WAV_BURST_SAMPLES or WAV_BURST_CYCLES
+//              CompleteHandler [func pointer]: called from the ISR when the
+//                  output has been parked, NULL = none
+// @returns:    [bool]: false = WAV_BURST_CYCLES requested for noise or a clip,
+//                  which have no cycle, burst left unchanged
+// *****************************************************************************
+bool WAV_Burst_Init(uint_fast32_t count, WAV_BurstUnit unit, void (* CompleteHandler)(void));
+
+
+// *****************************************************************************
+// @desc:       Starts one burst. Ignored while a burst is still running. May be
+//                  called from main or from an interrupt, see
+//                  WAV_Burst_SetGatePin() and WAV_Burst_SetGateTimer(). The
+//                  timer restarts from 0, so the first sample is written
+//                  exactly one sample interval after this call
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Burst_Trigger(void);
+
+
+// *****************************************************************************
+// @desc:       Checks if a burst is still being output
+// @args:       None
+// @returns:    [bool]: true = running
+// *****************************************************************************
+bool WAV_Burst_IsRunning(void);
+
+
+// *****************************************************************************
+// @desc:       Starts a burst on an edge of a GPIO pin. Uses the change
+//                  notification interrupt of the port, so latency is the
+//                  fixed interrupt entry time plus one sample interval.
+//                  Only pins with a change notification handler can be used
+//                  (PORTA PIN0-PIN4, PORTB PIN0-PIN15)
+// @args:       port [GPIO_Port]: PORT_A or PORT_B
+//              pin [GPIO_Pin]: PINx
+//              edge [GPIO_EdgeType]: RISING, FALLING or ANY
+// @returns:    None
+// *****************************************************************************
+void WAV_Burst_SetGatePin(GPIO_Port port, GPIO_Pin pin, GPIO_EdgeType edge);
+
+
+// *****************************************************************************
+// @desc:       Starts a burst periodically from the Timer1 interrupt. Timer1
+//                  must be initialized and started, see TMR1_Start()
+// @args:       interval [uint_fast16_t]: burst repetition interval in ms
+//              priority [uint_fast8_t]: Timer1 interrupt priority, should be
+//                  above INT_PRIORITY
+// @returns:    None
+// *****************************************************************************
+void WAV_Burst_SetGateTimer(uint_fast16_t interval, uint_fast8_t priority);
+
+
+// *****************************************************************************
+// @desc:       Initialize DMA streaming output at pin PA3/RA3/AN3. Thin wrapper
+//                  of DAC_StreamInit(): SCCP8 paces a DMA channel that copies
+//                  buffer into DAC1DATH, so there is no per-sample interrupt.
+//                  buffer is used as a ping-pong pair of halves:
+//                  RefillHandler is called from the DMA interrupt with the
+//                  half that was just played out
 // @args:       activeOnIdle [bool]: true = active on idle
 //              activeOnSleep [bool]: true = active on sleep
-//              interval_us [uint_fast32_t]: interval in us. Recommended minimum
-//                  is 10us (100kHz sampling frequency)
-//              priority [uint_fast8_t]: interrupt priority
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+//              buffer [uint16_t *]: DAC samples in data RAM, must stay valid
+//                  while streaming
+//              length [uint_fast16_t]: number of samples in buffer, even
+//              RefillHandler [func pointer]: called with the free half and its
+//                  sample count. NULL = buffer is replayed as is with no CPU
+//                  involvement
+// @returns:    None
+// *****************************************************************************
+void WAV_Stream_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t samplingFreq, uint16_t *buffer, uint_fast16_t length, void (* RefillHandler)(uint16_t *block, uint_fast16_t count));
+
+
+// *****************************************************************************
+// @desc:       Starts the DMA streaming output at pin RA3
+// @args:       None
 // @returns:    None
 // *****************************************************************************
-void SCCP8_Init(bool activeOnIdle, bool activeOnSleep, uint_fast32_t interval_us, uint_fast8_t priority);
+void WAV_Stream_Start(void);
+
+
+// *****************************************************************************
+// @desc:       Stops the DMA streaming output at pin RA3
+// @args:       None
+// @returns:    None
+// *****************************************************************************
+void WAV_Stream_Stop(void);
+
+
+// *****************************************************************************
+// @desc:       Initialize Sine wave generator in DMA streaming mode. If buffer
+//                  holds a whole number of cycles it is filled once and
+//                  replayed by DMA alone, otherwise the DDS engine refills
+//                  each half from the DMA interrupt. A replayed buffer fixes
+//                  frequency and amplitude, WAV_Sine_Update() returns false.
+//                  Use WAV_Stream_Start() and WAV_Stream_Stop() to control the
+//                  output
+// @args:       activeOnIdle [bool]: true = active on idle
+//              activeOnSleep [bool]: true = active on sleep
+//              freq [uint_fast16_t]: frequency in Hz
+//              samplingFreq [uint_fast32_t]: sampling frequency in Hz
+//              buffer [uint16_t *]: sample buffer in data RAM
+//              length [uint_fast16_t]: number of samples in buffer, even
+// @returns:    None
+// *****************************************************************************
+void WAV_Sine_StreamInit(bool activeOnIdle, bool activeOnSleep, uint_fast16_t freq, uint_fast32_t samplingFreq, uint16_t *buffer, uint_fast16_t length);
+
+
+// *****************************************************************************
+// @desc:       Returns the sampling rate actually produced by SCCP8 for the
+//                  last initialized generator. The requested rate is rounded
+//                  to a whole number of Fcy ticks, so e.g. at Fosc = 100MHz
+//                  a 150kHz request gives 50MHz / 333 = 150150Hz
+// @args:       None
+// @returns:    [uint_fast32_t]: sampling frequency in Hz, rounded
+// *****************************************************************************
+uint_fast32_t WAV_GetSamplingFrequency(void);
+
+
+// *****************************************************************************
+// @desc:       Returns the SCCP8 period of the last initialized generator
+// @args:       None
+// @returns:    [uint_fast32_t]: Fcy ticks per sample
+// *****************************************************************************
+uint_fast32_t WAV_GetSamplingPeriod(void);
+
+
+// *****************************************************************************
+// @desc:       Picks the sampling rate within minFreq..maxFreq at which the DDS
+//                  engine comes closest to freq_mHz. Up to WAV_RATE_SEARCH
+//                  timer periods are tried starting at maxFreq, ties keep the
+//                  higher rate. Pass the result to the generator's Init
+//                  function. Uses the current clock, call after Sys_Init().
+//                  Periods are not shorter than SCCP8_ISR_MIN_PERIOD
+// @args:       freq_mHz [uint_fast32_t]: wanted output frequency in mHz
+//              minFreq [uint_fast32_t]: lowest acceptable sampling rate in Hz
+//              maxFreq [uint_fast32_t]: highest acceptable sampling rate in Hz
+// @returns:    [uint_fast32_t]: Fcy / best period, rounded to whole Hz. Init
+//                  rounds it back to the same period when the period is below
+//                  sqrt(Fcy), i.e. for rates above about 7kHz at Fcy = 50MHz.
+//                  Check lower rates with WAV_GetSamplingPeriod()
+// *****************************************************************************
+uint_fast32_t WAV_BestSamplingFrequency(uint_fast32_t freq_mHz, uint_fast32_t minFreq, uint_fast32_t maxFreq);
 
 #endif	// NANOLAY_WAVGEN_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+/* ************************************************************************** */
+// Nanolay - Wave Generator Tables Source File
+//
+// Description:     GENERATED by tools/gen_wavtables.py, do not edit by hand.
+//                  Quarter wave sine tables for the wave generator, placed in
+//                  program memory and read through the PSV window.
+//
+// Target Device:   dsPIC33CKxxxMP202
+//
+// Parameters:      SAMPLE_SIZE = 1600, WAV_TABLE_BITS = 12,
+//                  SINE_AMPLITUDE = 1842, SINE_MIDSCALE = 2048
+/* ************************************************************************** */
+
+#include "nanolay_wavgen.h"
+
+
+#if (SAMPLE_SIZE != 1600) || (WAV_TABLE_BITS != 12) || (SINE_AMPLITUDE != 1842) || (SINE_MIDSCALE != 2048)
+#error "nanolay_wavtables.c does not match nanolay_wavgen.h, run: python3 tools/gen_wavtables.py"
+#endif
+
+
+// First quadrant of the sine in DAC LSB, offset from SINE_MIDSCALE. Entry
+// [SINE_QTABLE_SIZE] is the peak so the falling quadrants mirror exactly.
+const int16_t __attribute__((space(auto_psv))) sineQTable[SINE_QTABLE_SIZE + 1] = {
+0x0000,0x0007,0x000e,0x0016,0x001d,0x0024,0x002b,0x0033,0x003a,0x0041,0x0048,0x0050,0x0057,0x005e,0x0065,0x006c,
+0x0074,0x007b,0x0082,0x0089,0x0091,0x0098,0x009f,0x00a6,0x00ad,0x00b5,0x00bc,0x00c3,0x00ca,0x00d1,0x00d9,0x00e0,
+0x00e7,0x00ee,0x00f5,0x00fc,0x0104,0x010b,0x0112,0x0119,0x0120,0x0127,0x012e,0x0136,0x013d,0x0144,0x014b,0x0152,
+0x0159,0x0160,0x0167,0x016e,0x0176,0x017d,0x0184,0x018b,0x0192,0x0199,0x01a0,0x01a7,0x01ae,0x01b5,0x01bc,0x01c3,
+0x01ca,0x01d1,0x01d8,0x01df,0x01e6,0x01ed,0x01f4,0x01fb,0x0202,0x0209,0x0210,0x0217,0x021e,0x0225,0x022b,0x0232,
+0x0239,0x0240,0x0247,0x024e,0x0255,0x025b,0x0262,0x0269,0x0270,0x0277,0x027e,0x0284,0x028b,0x0292,0x0299,0x029f,
+0x02a6,0x02ad,0x02b4,0x02ba,0x02c1,0x02c8,0x02ce,0x02d5,0x02dc,0x02e2,0x02e9,0x02ef,0x02f6,0x02fd,0x0303,0x030a,
+0x0310,0x0317,0x031d,0x0324,0x032a,0x0331,0x0337,0x033e,0x0344,0x034b,0x0351,0x0358,0x035e,0x0364,0x036b,0x0371,
+0x0377,0x037e,0x0384,0x038a,0x0391,0x0397,0x039d,0x03a3,0x03aa,0x03b0,0x03b6,0x03bc,0x03c2,0x03c9,0x03cf,0x03d5,
+0x03db,0x03e1,0x03e7,0x03ed,0x03f3,0x03f9,0x03ff,0x0405,0x040b,0x0411,0x0417,0x041d,0x0423,0x0429,0x042f,0x0435,
+0x043b,0x0441,0x0446,0x044c,0x0452,0x0458,0x045e,0x0463,0x0469,0x046f,0x0474,0x047a,0x0480,0x0485,0x048b,0x0491,
+0x0496,0x049c,0x04a1,0x04a7,0x04ac,0x04b2,0x04b7,0x04bd,0x04c2,0x04c8,0x04cd,0x04d2,0x04d8,0x04dd,0x04e2,0x04e8,
+0x04ed,0x04f2,0x04f7,0x04fd,0x0502,0x0507,0x050c,0x0511,0x0516,0x051c,0x0521,0x0526,0x052b,0x0530,0x0535,0x053a,
+0x053f,0x0544,0x0549,0x054e,0x0552,0x0557,0x055c,0x0561,0x0566,0x056a,0x056f,0x0574,0x0579,0x057d,0x0582,0x0587,
+0x058b,0x0590,0x0594,0x0599,0x059e,0x05a2,0x05a7,0x05ab,0x05af,0x05b4,0x05b8,0x05bd,0x05c1,0x05c5,0x05ca,0x05ce,
+0x05d2,0x05d6,0x05db,0x05df,0x05e3,0x05e7,0x05eb,0x05ef,0x05f3,0x05f8,0x05fc,0x0600,0x0604,0x0608,0x060b,0x060f,
+0x0613,0x0617,0x061b,0x061f,0x0623,0x0626,0x062a,0x062e,0x0631,0x0635,0x0639,0x063c,0x0640,0x0644,0x0647,0x064b,
+0x064e,0x0652,0x0655,0x0658,0x065c,0x065f,0x0663,0x0666,0x0669,0x066d,0x0670,0x0673,0x0676,0x0679,0x067c,0x0680,
+0x0683,0x0686,0x0689,0x068c,0x068f,0x0692,0x0695,0x0698,0x069b,0x069d,0x06a0,0x06a3,0x06a6,0x06a9,0x06ab,0x06ae,
+0x06b1,0x06b3,0x06b6,0x06b9,0x06bb,0x06be,0x06c0,0x06c3,0x06c5,0x06c8,0x06ca,0x06cc,0x06cf,0x06d1,0x06d3,0x06d6,
+0x06d8,0x06da,0x06dc,0x06de,0x06e1,0x06e3,0x06e5,0x06e7,0x06e9,0x06eb,0x06ed,0x06ef,0x06f1,0x06f3,0x06f4,0x06f6,
+0x06f8,0x06fa,0x06fc,0x06fd,0x06ff,0x0701,0x0702,0x0704,0x0706,0x0707,0x0709,0x070a,0x070c,0x070d,0x070f,0x0710,
+0x0711,0x0713,0x0714,0x0715,0x0717,0x0718,0x0719,0x071a,0x071b,0x071c,0x071e,0x071f,0x0720,0x0721,0x0722,0x0723,
+0x0723,0x0724,0x0725,0x0726,0x0727,0x0728,0x0728,0x0729,0x072a,0x072a,0x072b,0x072c,0x072c,0x072d,0x072d,0x072e,
+0x072e,0x072f,0x072f,0x0730,0x0730,0x0730,0x0731,0x0731,0x0731,0x0731,0x0731,0x0732,0x0732,0x0732,0x0732,0x0732,
+0x0732
+};
+
+
+// First quadrant of the sine in Q15 (peak 0x7FFF), used where tones are scaled
+// and mixed in the DSP accumulator.
+const int16_t __attribute__((space(auto_psv))) sineQ15QTable[SINE_QTABLE_SIZE + 1] = {
+0x0000,0x0081,0x0101,0x0182,0x0203,0x0283,0x0304,0x0385,0x0405,0x0486,0x0506,0x0587,0x0608,0x0688,0x0709,0x0789,
+0x0809,0x088a,0x090a,0x098b,0x0a0b,0x0a8b,0x0b0b,0x0b8c,0x0c0c,0x0c8c,0x0d0c,0x0d8c,0x0e0c,0x0e8c,0x0f0b,0x0f8b,
+0x100b,0x108a,0x110a,0x1189,0x1209,0x1288,0x1308,0x1387,0x1406,0x1485,0x1504,0x1583,0x1602,0x1680,0x16ff,0x177d,
+0x17fc,0x187a,0x18f9,0x1977,0x19f5,0x1a73,0x1af1,0x1b6e,0x1bec,0x1c69,0x1ce7,0x1d64,0x1de1,0x1e5e,0x1edb,0x1f58,
+0x1fd5,0x2051,0x20ce,0x214a,0x21c6,0x2242,0x22be,0x233a,0x23b6,0x2431,0x24ad,0x2528,0x25a3,0x261e,0x2698,0x2713,
+0x278e,0x2808,0x2882,0x28fc,0x2976,0x29ef,0x2a69,0x2ae2,0x2b5b,0x2bd4,0x2c4d,0x2cc6,0x2d3e,0x2db7,0x2e2f,0x2ea7,
+0x2f1e,0x2f96,0x300d,0x3084,0x30fb,0x3172,0x31e9,0x325f,0x32d5,0x334b,0x33c1,0x3437,0x34ac,0x3521,0x3596,0x360b,
+0x3680,0x36f4,0x3768,0x37dc,0x384f,0x38c3,0x3936,0x39a9,0x3a1c,0x3a8e,0x3b01,0x3b73,0x3be5,0x3c56,0x3cc8,0x3d39,
+0x3daa,0x3e1a,0x3e8b,0x3efb,0x3f6b,0x3fda,0x404a,0x40b9,0x4128,0x4196,0x4205,0x4273,0x42e1,0x434e,0x43bc,0x4429,
+0x4495,0x4502,0x456e,0x45da,0x4646,0x46b1,0x471c,0x4787,0x47f2,0x485c,0x48c6,0x4930,0x4999,0x4a02,0x4a6b,0x4ad4,
+0x4b3c,0x4ba4,0x4c0c,0x4c73,0x4cda,0x4d41,0x4da7,0x4e0d,0x4e73,0x4ed9,0x4f3e,0x4fa3,0x5007,0x506c,0x50d0,0x5133,
+0x5196,0x51f9,0x525c,0x52be,0x5320,0x5382,0x53e3,0x5445,0x54a5,0x5506,0x5566,0x55c5,0x5625,0x5684,0x56e2,0x5741,
+0x579f,0x57fc,0x5859,0x58b6,0x5913,0x596f,0x59cb,0x5a27,0x5a82,0x5add,0x5b37,0x5b91,0x5beb,0x5c44,0x5c9d,0x5cf6,
+0x5d4e,0x5da6,0x5dfe,0x5e55,0x5eab,0x5f02,0x5f58,0x5fae,0x6003,0x6058,0x60ac,0x6100,0x6154,0x61a8,0x61fb,0x624d,
+0x629f,0x62f1,0x6343,0x6394,0x63e4,0x6435,0x6484,0x64d4,0x6523,0x6572,0x65c0,0x660e,0x665b,0x66a8,0x66f5,0x6741,
+0x678d,0x67d8,0x6824,0x686e,0x68b8,0x6902,0x694b,0x6994,0x69dd,0x6a25,0x6a6d,0x6ab4,0x6afb,0x6b41,0x6b87,0x6bcd,
+0x6c12,0x6c57,0x6c9b,0x6cdf,0x6d22,0x6d65,0x6da8,0x6dea,0x6e2c,0x6e6d,0x6eae,0x6eee,0x6f2e,0x6f6e,0x6fad,0x6fec,
+0x702a,0x7068,0x70a5,0x70e2,0x711e,0x715a,0x7196,0x71d1,0x720c,0x7246,0x7280,0x72b9,0x72f2,0x732a,0x7362,0x7399,
+0x73d0,0x7407,0x743d,0x7473,0x74a8,0x74dd,0x7511,0x7545,0x7578,0x75ab,0x75dd,0x760f,0x7641,0x7672,0x76a2,0x76d2,
+0x7702,0x7731,0x7760,0x778e,0x77bc,0x77e9,0x7816,0x7842,0x786e,0x7899,0x78c4,0x78ee,0x7918,0x7942,0x796b,0x7993,
+0x79bb,0x79e3,0x7a0a,0x7a30,0x7a56,0x7a7c,0x7aa1,0x7ac6,0x7aea,0x7b0e,0x7b31,0x7b53,0x7b76,0x7b97,0x7bb9,0x7bd9,
+0x7bfa,0x7c19,0x7c39,0x7c57,0x7c76,0x7c93,0x7cb1,0x7cce,0x7cea,0x7d06,0x7d21,0x7d3c,0x7d56,0x7d70,0x7d89,0x7da2,
+0x7dbb,0x7dd2,0x7dea,0x7e01,0x7e17,0x7e2d,0x7e42,0x7e57,0x7e6c,0x7e7f,0x7e93,0x7ea6,0x7eb8,0x7eca,0x7edb,0x7eec,
+0x7efd,0x7f0c,0x7f1c,0x7f2b,0x7f39,0x7f47,0x7f54,0x7f61,0x7f6e,0x7f79,0x7f85,0x7f90,0x7f9a,0x7fa4,0x7fad,0x7fb6,
+0x7fbe,0x7fc6,0x7fcd,0x7fd4,0x7fdb,0x7fe0,0x7fe6,0x7feb,0x7fef,0x7ff3,0x7ff6,0x7ff9,0x7ffb,0x7ffd,0x7ffe,0x7fff,
+0x7fff
+};
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Nanolay - Wave Generator Table Generator
+#
+# Description:     Generates nanolay_lib/nanolay_wavtables.c from the table
+#                  parameters in nanolay_lib/nanolay_wavgen.h (SAMPLE_SIZE,
+#                  WAV_TABLE_BITS, SINE_AMPLITUDE, SINE_MIDSCALE). Run it after
+#                  changing any of them; the generated file refuses to compile
+#                  against a header with different parameters.
+#
+# Usage:           python3 tools/gen_wavtables.py [--size N] [--bits B]
+#                      [--amplitude A] [--offset O]
+# *****************************************************************************
+
+import argparse
+import math
+import os
+import re
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+HEADER = os.path.join(ROOT, 'nanolay_lib', 'nanolay_wavgen.h')
+DAC_HEADER = os.path.join(ROOT, 'nanolay_lib', 'nanolay_dac.h')
+OUTPUT = os.path.join(ROOT, 'nanolay_lib', 'nanolay_wavtables.c')
+DAC_BITS = 12
+
+
+def read_define(path, name):
+    with open(path) as f:
+        m = re.search(r'^#define\s+%s\s+(0x[0-9A-Fa-f]+|\d+)' % name, f.read(), re.M)
+    if m is None:
+        raise SystemExit('%s not found in %s' % (name, path))
+    return int(m.group(1), 0)
+
+
+def quarter_table(size, peak, step):
+    # size + 1 entries so the peak is stored and falling quadrants mirror exactly
+    return [int(round(peak * math.sin(math.pi / 2 * i / size) / step)) * step for i in range(size + 1)]
+
+
+def format_table(values):
+    rows = [','.join('0x%04x' % (v & 0xFFFF) for v in values[i:i + 16]) for i in range(0, len(values), 16)]
+    return ',\n'.join(rows)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Generate nanolay_lib/nanolay_wavtables.c')
+    ap.add_argument('--size', type=int, default=read_define(HEADER, 'SAMPLE_SIZE'), help='samples per cycle, multiple of 4')
+    ap.add_argument('--bits', type=int, default=read_define(HEADER, 'WAV_TABLE_BITS'), help='table resolution, 1 to 12 bits')
+    ap.add_argument('--amplitude', type=int, default=read_define(HEADER, 'SINE_AMPLITUDE'), help='sine peak in DAC LSB')
+    ap.add_argument('--offset', type=int, default=read_define(HEADER, 'SINE_MIDSCALE'), help='DAC value at zero phase')
+    args = ap.parse_args()
+
+    min_dac = read_define(DAC_HEADER, 'MIN_DAC_VAL')
+    max_dac = read_define(DAC_HEADER, 'MAX_DAC_VAL')
+    if args.size <= 0 or args.size % 4:
+        raise SystemExit('size must be a positive multiple of 4')
+    if not 1 <= args.bits <= DAC_BITS:
+        raise SystemExit('bits must be between 1 and %d' % DAC_BITS)
+    if args.offset - args.amplitude < min_dac or args.offset + args.amplitude > max_dac:
+        raise SystemExit('offset +/- amplitude must stay within %d..%d' % (min_dac, max_dac))
+
+    qsize = args.size // 4
+    step = 1 << (DAC_BITS - args.bits)
+    dac = quarter_table(qsize, args.amplitude, step)
+    q15 = quarter_table(qsize, 32767, 1)
+
+    with open(OUTPUT, 'w') as f:
+        f.write('''/* ************************************************************************** */
+// Nanolay - Wave Generator Tables Source File
+//
+// Description:     GENERATED by tools/gen_wavtables.py, do not edit by hand.
+//                  Quarter wave sine tables for the wave generator, placed in
+//                  program memory and read through the PSV window.
+//
+// Target Device:   dsPIC33CKxxxMP202
+//
+// Parameters:      SAMPLE_SIZE = %d, WAV_TABLE_BITS = %d,
+//                  SINE_AMPLITUDE = %d, SINE_MIDSCALE = %d
+/* ************************************************************************** */
+
+#include "nanolay_wavgen.h"
+
+
+#if (SAMPLE_SIZE != %d) || (WAV_TABLE_BITS != %d) || (SINE_AMPLITUDE != %d) || (SINE_MIDSCALE != %d)
+#error "nanolay_wavtables.c does not match nanolay_wavgen.h, run: python3 tools/gen_wavtables.py"
+#endif
+
+
+// First quadrant of the sine in DAC LSB, offset from SINE_MIDSCALE. Entry
+// [SINE_QTABLE_SIZE] is the peak so the falling quadrants mirror exactly.
+const int16_t __attribute__((space(auto_psv))) sineQTable[SINE_QTABLE_SIZE + 1] = {
+%s
+};
+
+
+// First quadrant of the sine in Q15 (peak 0x7FFF), used where tones are scaled
+// and mixed in the DSP accumulator.
+const int16_t __attribute__((space(auto_psv))) sineQ15QTable[SINE_QTABLE_SIZE + 1] = {
+%s
+};
+''' % (args.size, args.bits, args.amplitude, args.offset,
+       args.size, args.bits, args.amplitude, args.offset,
+       format_table(dac), format_table(q15)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,197 @@
+/* ************************************************************************** */
+// Nanolay - DDS Host Check
+//
+// Description:     Checks the tuning word math of nanolay_dds.c against a
+//                  128bit reference on the host and benchmarks the calls used
+//                  at init time and in the sample ISR. Exits with 1 if any
+//                  check fails.
+//
+// Target Device:   Host
+//
+// Usage:           make -C tools/host check
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+#include "nanolay_dds.h"
+
+
+#define CHECK_RUNS      200000
+#define BENCH_RUNS      2000000
+#define BENCH_QSIZE     400                                                     // SINE_QTABLE_SIZE of the default tables
+
+
+typedef unsigned __int128 u128;
+
+
+static const uint32_t clocks[] = {4000000UL, 10000000UL, 25000000UL, 50000000UL};   // SCCP_CLK_FREQ_xMHZ
+static uint32_t seed = 1;
+static int16_t qTable[BENCH_QSIZE + 1];
+
+
+static uint32_t Rand(void){
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+
+static uint32_t RefTuningWord(uint32_t freq_mHz, uint32_t period, uint32_t clockFreq){
+    u128 num = ((u128) freq_mHz * period) << 32;
+    u128 den = (u128) clockFreq * DDS_MILLIHZ_PER_HZ;
+
+    return (uint32_t) ((num + den / 2) / den);                                  // ties round up like DDS_TuningWordPeriod()
+}
+
+
+static double Now(void){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+
+// Tuning word per Fs in whole Hz and per timer period, and the frequency error
+// reported by DDS_FrequencyError(), each against the 128bit reference
+static int CheckTuningWords(void){
+    uint32_t i, clock, period, freq_mHz, word, ref, error;
+    uint32_t badWord = 0, badPeriod = 0, badError = 0;
+    double worst = 0, fs, diff;
+
+    for (i = 0; i < CHECK_RUNS; i++){
+        clock = clocks[i % 4];
+        period = 2 + Rand() % 5000;
+        fs = (double) clock / period;
+        freq_mHz = Rand() % (uint32_t) (fs * 500.0);                            // up to Fs / 2
+
+        word = DDS_TuningWord(freq_mHz, clock / period);
+        if (word != RefTuningWord(freq_mHz, 1, clock / period)){
+            badWord++;
+        }
+
+        word = DDS_TuningWordPeriod(freq_mHz, period, clock);
+        ref = RefTuningWord(freq_mHz, period, clock);
+        if (word != ref){
+            badPeriod++;
+        }
+
+        diff = (double) word * fs / 4294967296.0 - freq_mHz / 1000.0;           // Hz
+        if (diff < 0){
+            diff = -diff;
+        }
+        if (diff > worst){
+            worst = diff;
+        }
+        error = DDS_FrequencyError(freq_mHz, period, clock);
+        if ((error > diff * 1e9 + 1.0) || (error + 1.0 < diff * 1e9)){          // nHz, 1 nHz of rounding allowed
+            badError++;
+        }
+    }
+
+    printf("tuning word (Hz rate)      %u mismatches\n", badWord);
+    printf("tuning word (timer period) %u mismatches\n", badPeriod);
+    printf("frequency error            %u mismatches, worst %.3g Hz\n", badError, worst);
+    return (badWord != 0) || (badPeriod != 0) || (badError != 0);
+}
+
+
+// The produced frequency must round back within half a tuning word LSB
+static int CheckFrequency(void){
+    uint32_t i, clock, period, word, freq_mHz;
+    uint32_t bad = 0;
+    double exact;
+
+    for (i = 0; i < CHECK_RUNS; i++){
+        clock = clocks[i % 4];
+        period = 2 + Rand() % 5000;
+        word = Rand() >> 1;
+        exact = (double) word * clock / period / 4294967296.0 * 1000.0;
+        if (exact >= 4294967295.0){
+            continue;                                                           // above ~4.29MHz, not representable in mHz
+        }
+        freq_mHz = DDS_FrequencyPeriod(word, period, clock);
+        if ((freq_mHz > exact + 0.5001) || (freq_mHz + 0.5001 < exact)){
+            bad++;
+        }
+    }
+    printf("produced frequency         %u mismatches\n", bad);
+    return bad != 0;
+}
+
+
+static int CheckMulQ30(void){
+    uint32_t i, word, q30, rem, got;
+    uint32_t bad = 0;
+    u128 ref;
+
+    for (i = 0; i < CHECK_RUNS; i++){
+        word = Rand();
+        q30 = Rand() & ((i & 1) ? 0x7FFFFFFFUL : 0xFFFFUL);                     // small ratios as used by the log sweep
+        rem = Rand() & 0x3FFFFFFFUL;
+        ref = (u128) word * q30 + rem;
+        if ((ref >> 62) != 0){
+            continue;                                                           // result does not fit 32bit
+        }
+        got = DDS_MulQ30(word, q30, &rem);
+        if ((got != (uint32_t) (ref >> 30)) || (rem != (uint32_t) (ref & 0x3FFFFFFFUL))){
+            bad++;
+        }
+    }
+    printf("Q30 multiply               %u mismatches\n", bad);
+    return bad != 0;
+}
+
+
+static void Bench(void){
+    volatile uint32_t sink = 0;
+    uint32_t i, phase = 0, word;
+    double t;
+
+    for (i = 0; i <= BENCH_QSIZE; i++){
+        qTable[i] = (int16_t) i;
+    }
+
+    t = Now();
+    for (i = 0; i < BENCH_RUNS; i++){
+        sink += DDS_TuningWordPeriod(i, 1000 + (i & 1023), 50000000UL);
+    }
+    printf("DDS_TuningWordPeriod       %.1f ns/call\n", (Now() - t) * 1e9 / BENCH_RUNS);
+
+    word = DDS_TuningWord(1234567, 100000);
+    t = Now();
+    for (i = 0; i < BENCH_RUNS; i++){
+        sink += (uint32_t) DDS_QuarterWave(phase, qTable, BENCH_QSIZE);
+        phase += word;
+    }
+    printf("DDS_QuarterWave            %.1f ns/sample\n", (Now() - t) * 1e9 / BENCH_RUNS);
+
+    t = Now();
+    for (i = 0; i < BENCH_RUNS; i++){
+        sink += (uint32_t) DDS_QuarterWaveInterp(phase, qTable, BENCH_QSIZE);
+        phase += word;
+    }
+    printf("DDS_QuarterWaveInterp      %.1f ns/sample\n", (Now() - t) * 1e9 / BENCH_RUNS);
+    (void) sink;
+}
+
+
+int main(void){
+    int fail = 0;
+
+    fail |= CheckTuningWords();
+    fail |= CheckFrequency();
+    fail |= CheckMulQ30();
+    Bench();
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
@@ -0,0 +1,387 @@
+/* ************************************************************************** */
+// Nanolay - DSP Host Check
+//
+// Description:     Checks nanolay_dsp.c on the host: the emulated saturating
+//                  accumulator store, and the FFT, Goertzel, FIR and IIR
+//                  results against double and exact integer references,
+//                  the rejection of invalid sizes, and the Goertzel result at
+//                  the largest state a 4096 sample block can reach.
+//                  Checksums of the fixed point outputs for fixed input
+//                  vectors catch any change of the results; they are printed
+//                  so a device run of the same vectors can be compared. Exits
+//                  with 1 if any check fails.
+//
+// Target Device:   Host
+//
+// Usage:           make -C tools/host check
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <math.h>
+#include "nanolay_dsp.h"
+
+
+#define RATE            100000UL
+#define POINTS          DSP_FFT_MAX_POINTS
+#define BLOCK           500
+#define FIR_TAPS        31
+#define IIR_SECTIONS    2
+#define GOERTZEL_BINS   3
+#define GOERTZEL_MAX    DSP_GOERTZEL_MAX_LENGTH
+#define IIR_IMPULSE     4096                                                    // impulse response length summed for the IIR error bound
+
+#define GOLDEN_FFT      0x2B2940F0UL                                            // checksums of the outputs for the vectors below
+#define GOLDEN_GOERTZEL 0x18217871UL
+#define GOLDEN_FIR      0x37B601DBUL
+#define GOLDEN_IIR      0x66FE3B5BUL
+
+
+static uint32_t seed = 1;
+static uint16_t samples[GOERTZEL_MAX];
+static DSP_Complex data[POINTS];
+static uint32_t power[POINTS / 2];
+static int16_t in[BLOCK];
+static int16_t out[BLOCK];
+static int16_t firCoeff[FIR_TAPS];
+static int16_t firDelay[2 * FIR_TAPS];
+static DSP_BiquadCoeff iirCoeff[IIR_SECTIONS];
+static DSP_BiquadState iirState[IIR_SECTIONS];
+
+
+static uint32_t Rand(void){
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+
+// FNV-1a over 16bit words, low byte first
+static uint32_t Hash(uint32_t h, const void *buf, unsigned words){
+    const uint16_t *w = buf;
+
+    while (words--){
+        h = (h ^ (*w & 0xFF)) * 16777619UL;
+        h = (h ^ (*w++ >> 8)) * 16777619UL;
+    }
+    return h;
+}
+
+
+// Tone plus uniform noise around ADC midscale, kept within 12bit
+static void Tone(uint16_t *buf, unsigned count, double freq, double amplitude, int noise){
+    long v;
+    unsigned n;
+
+    for (n = 0; n < count; n++){
+        v = lround(DSP_ADC_MIDSCALE + amplitude * sin(2 * M_PI * freq * n / RATE));
+        if (noise){
+            v += (long) (Rand() % (2 * noise + 1)) - noise;
+        }
+        buf[n] = (uint16_t) ((v < 0) ? 0 : (v > 4095) ? 4095 : v);
+    }
+}
+
+
+static int CheckSac(void){
+    static const struct { int64_t acc; int shift; int16_t expect; } cases[] = {
+        {0x12345678LL, 0, 0x1234},
+        {-0x12345678LL, 0, (int16_t) 0xEDCB},                                   // truncates toward minus infinity
+        {0x7FFFFFFFLL, 0, 0x7FFF},
+        {0x80000000LL, 0, 0x7FFF},                                              // 1.0 and above saturate
+        {-0x80000000LL, 0, (int16_t) 0x8000},
+        {-0x80000001LL, 0, (int16_t) 0x8000},
+        {0x7FFFFFFFFFLL, 7, 0x7FFF},                                            // largest 40bit value
+        {0x40000000LL, 1, 0x2000},
+        {0x40000000LL, -1, 0x7FFF},
+        {0x20000000LL, -1, 0x4000},
+        {0x00010000LL, -8, 0x0100},
+    };
+    unsigned i, bad = 0;
+
+    for (i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+        if (DSP_Sac(cases[i].acc, cases[i].shift) != cases[i].expect){
+            bad++;
+        }
+    }
+    printf("accumulator store          %u mismatches\n", bad);
+    return bad != 0;
+}
+
+
+// Output is the DFT / points, compared bin by bin in Q15 LSB
+static int CheckFFT(uint32_t *hash){
+    double re, im, a, worst = 0;
+    unsigned n, k;
+
+    DSP_FFTInit();
+    Tone(samples, POINTS, RATE * 17.0 / POINTS, 1200, 0);
+    Tone(samples + POINTS, POINTS, 2718.0, 600, 40);
+    for (n = 0; n < POINTS; n++){
+        samples[n] = (uint16_t) (samples[n] + samples[POINTS + n] - DSP_ADC_MIDSCALE);
+    }
+    DSP_FromADC(in, samples, POINTS);
+    DSP_FFTLoad(data, samples, POINTS);
+    if (DSP_FFT(data, 0) || DSP_FFT(data, 1) || DSP_FFT(data, 96) || DSP_FFT(data, 2 * POINTS)){
+        printf("FFT                        invalid points accepted\n");
+        *hash = 0;
+        return 1;
+    }
+    DSP_FFT(data, POINTS);
+
+    for (k = 0; k < POINTS; k++){
+        re = 0;
+        im = 0;
+        for (n = 0; n < POINTS; n++){
+            a = -2 * M_PI * (double) ((k * n) % POINTS) / POINTS;
+            re += in[n] * cos(a);
+            im += in[n] * sin(a);
+        }
+        re = fabs(re / POINTS - data[k].re);
+        im = fabs(im / POINTS - data[k].im);
+        worst = (re > worst) ? re : worst;
+        worst = (im > worst) ? im : worst;
+    }
+    DSP_FFTPower(data, power, POINTS / 2);
+    *hash = Hash(Hash(2166136261UL, data, 2 * POINTS), power, POINTS);
+    printf("FFT                        worst %.2f LSB\n", worst);
+    return worst > 8.0;                                                         // at most one truncation per stage
+}
+
+
+// Runs the recursion of DSP_GoertzelBlock() in 64bit and the result in long
+// double. Returns the peak state so a 32bit overflow shows up
+static int64_t RefGoertzel(const uint16_t *x, unsigned length, int16_t c, long double *amplitude){
+    int64_t s0, s1 = 0, s2 = 0, peak = 0;
+    long double p;
+    unsigned n;
+
+    for (n = 0; n < length; n++){
+        s0 = ((int64_t) x[n] - DSP_ADC_MIDSCALE) + (s1 * c >> 14) - s2;         // DSP_MulQ14() is the floor of s1 * c / 2^14
+        s2 = s1;
+        s1 = s0;
+        peak = (llabs(s0) > peak) ? llabs(s0) : peak;
+    }
+    p = (long double) s1 * s1 + (long double) s2 * s2 - (long double) s1 * s2 * c / 16384;
+    *amplitude = 2 * sqrtl((p > 0) ? p : 0) / length;
+    return peak;
+}
+
+
+static int CheckGoertzel(uint32_t *hash){
+    static const uint32_t freqs[GOERTZEL_BINS] = {1000000, 1234500, 1000};      // mHz, on a bin, between bins, near DC
+    DSP_Goertzel g;
+    long double ref;
+    double worst = 0, diff, f;
+    int64_t peak;
+    unsigned i, bad = 0, length, blocks;
+
+    *hash = 2166136261UL;
+    if (DSP_GoertzelInit(&g, freqs, 0, RATE, 100) || DSP_GoertzelInit(&g, freqs, DSP_GOERTZEL_MAX_BINS + 1, RATE, 100) ||
+        DSP_GoertzelInit(&g, freqs, 1, RATE, 0) || DSP_GoertzelInit(&g, freqs, 1, RATE, GOERTZEL_MAX + 1)){
+        printf("Goertzel                   invalid setup accepted\n");
+        return 1;
+    }
+    // a tone on the bin, the others in the sidelobes; fed in uneven blocks
+    for (length = 100; length <= 1000; length += 900){
+        DSP_GoertzelInit(&g, freqs, GOERTZEL_BINS, RATE, length);
+        Tone(samples, length, 1000.0, 1500, 3);
+        for (blocks = 0, i = 0; i < length; i += 37){
+            blocks += DSP_GoertzelBlock(&g, samples + i, (length - i < 37) ? (length - i) : 37);
+        }
+        if ((blocks != 1) || (fabs(g.amplitude[0] - 1500.0) > 15.0)){
+            bad++;
+        }
+        for (i = 0; i < GOERTZEL_BINS; i++){
+            RefGoertzel(samples, length, g.coeff[i], &ref);
+            diff = fabs((double) (g.amplitude[i] - ref));
+            worst = (diff > worst) ? diff : worst;
+        }
+        *hash = Hash(*hash, g.amplitude, GOERTZEL_BINS);
+    }
+
+    // full scale input at the frequency 2cos(w) = 0x7FFF actually detects
+    DSP_GoertzelInit(&g, &freqs[2], 1, RATE, GOERTZEL_MAX);
+    f = acos(g.coeff[0] / 32768.0) * RATE / (2 * M_PI);
+    Tone(samples, GOERTZEL_MAX, f, 2047, 0);
+    DSP_GoertzelBlock(&g, samples, GOERTZEL_MAX);
+    peak = RefGoertzel(samples, GOERTZEL_MAX, g.coeff[0], &ref);
+    diff = fabs((double) (g.amplitude[0] - ref));
+    worst = (diff > worst) ? diff : worst;
+    if (fabs(g.amplitude[0] - 2047.0) > 60.0){                                  // about 5 cycles, the negative frequency leaks in
+        bad++;
+    }
+    *hash = Hash(*hash, g.amplitude, 1);
+
+    printf("Goertzel                   %u mismatches, worst %.2f LSB, peak state %.2g\n", bad, worst, (double) peak);
+    return (bad != 0) || (worst > 1.0) || (peak > INT32_MAX);
+}
+
+
+// Full precision sum truncated once, so the result must match exactly
+static int CheckFIR(uint32_t *hash){
+    DSP_FIR f;
+    int64_t sum;
+    double x;
+    unsigned n, k, bad = 0;
+    int16_t expect;
+
+    for (k = 0; k < FIR_TAPS; k++){                                             // Hamming windowed sinc, 5kHz cutoff
+        x = (double) k - (FIR_TAPS - 1) / 2.0;
+        firCoeff[k] = (int16_t) lround(32767 * 0.1 * ((x == 0) ? 1 : sin(M_PI * 0.1 * x) / (M_PI * 0.1 * x)) * (0.54 - 0.46 * cos(2 * M_PI * k / (FIR_TAPS - 1))));
+    }
+    Tone(samples, BLOCK, 3000.0, 1800, 200);
+    DSP_FromADC(in, samples, BLOCK);
+    DSP_FIRInit(&f, firCoeff, firDelay, FIR_TAPS);
+    DSP_FIRBlock(&f, in, out, BLOCK / 2);                                       // two blocks so the delay line carries over
+    DSP_FIRBlock(&f, in + BLOCK / 2, out + BLOCK / 2, BLOCK / 2);
+
+    for (n = 0; n < BLOCK; n++){
+        sum = 0;
+        for (k = 0; (k < FIR_TAPS) && (k <= n); k++){
+            sum += (int64_t) firCoeff[k] * in[n - k];
+        }
+        sum >>= 15;
+        expect = (sum > 32767) ? 32767 : (sum < -32768) ? -32768 : (int16_t) sum;
+        if (out[n] != expect){
+            bad++;
+        }
+    }
+    *hash = Hash(2166136261UL, out, BLOCK);
+    printf("FIR                        %u mismatches\n", bad);
+    return bad != 0;
+}
+
+
+// Bound of the output error from the saturating store alone. Each section
+// output is truncated by less than 1 LSB and that error runs through 1/A(z)
+// of its own section and all later sections, so the output is off by less
+// than the sum of the L1 norms of those impulse responses. The double
+// reference uses the same Q14 coefficients, so their quantisation cancels
+static double IIRTruncBound(const DSP_BiquadCoeff *c, unsigned sections){
+    static double h[IIR_IMPULSE];
+    double bound = 0, x1, x2, y1, y2, x0;
+    unsigned s, i, n;
+
+    for (s = 0; s < sections; s++){
+        y1 = y2 = 0;
+        for (n = 0; n < IIR_IMPULSE; n++){                                      // the test poles decay below 1e-100 by then
+            h[n] = ((n == 0) ? 1.0 : 0.0) - (c[s].a1 * y1 + c[s].a2 * y2) / 16384;
+            y2 = y1;
+            y1 = h[n];
+        }
+        for (i = s + 1; i < sections; i++){
+            x1 = x2 = y1 = y2 = 0;
+            for (n = 0; n < IIR_IMPULSE; n++){
+                x0 = h[n];
+                h[n] = (c[i].b0 * x0 + c[i].b1 * x1 + c[i].b2 * x2 - c[i].a1 * y1 - c[i].a2 * y2) / 16384;
+                x2 = x1;
+                x1 = x0;
+                y2 = y1;
+                y1 = h[n];
+            }
+        }
+        for (n = 0; n < IIR_IMPULSE; n++){
+            bound += fabs(h[n]);
+        }
+    }
+    return bound;
+}
+
+
+// Each section output is the full precision sum truncated once, so the result
+// must match an integer reference exactly. The distance to a double reference
+// shows the truncation error fed back through the poles and has to stay below
+// IIRTruncBound()
+static int CheckIIR(uint32_t *hash){
+    DSP_IIR f;
+    double w = 2 * M_PI * 2000.0 / RATE, alpha = sin(w) / (2 * 0.7071), a0 = 1 + alpha;
+    double x0, x1, x2, y0, y1, y2, worst = 0, diff, bound;
+    double ref[BLOCK];
+    int64_t sum;
+    int16_t exact[BLOCK], e0, e1, e2, f1, f2;
+    const DSP_BiquadCoeff *c;
+    unsigned n, i, bad = 0;
+
+    for (i = 0; i < IIR_SECTIONS; i++){                                         // 2kHz lowpass, 4th order
+        iirCoeff[i].b0 = (int16_t) lround(16384 * (1 - cos(w)) / 2 / a0);
+        iirCoeff[i].b1 = (int16_t) lround(16384 * (1 - cos(w)) / a0);
+        iirCoeff[i].b2 = iirCoeff[i].b0;
+        iirCoeff[i].a1 = (int16_t) lround(16384 * -2 * cos(w) / a0);
+        iirCoeff[i].a2 = (int16_t) lround(16384 * (1 - alpha) / a0);
+    }
+    Tone(samples, BLOCK, 1500.0, 1500, 200);
+    DSP_FromADC(in, samples, BLOCK);
+    for (n = 0; n < BLOCK; n++){
+        ref[n] = in[n];
+        exact[n] = in[n];
+    }
+    for (i = 0; i < IIR_SECTIONS; i++){
+        c = &iirCoeff[i];
+        x1 = x2 = y1 = y2 = 0;
+        e1 = e2 = f1 = f2 = 0;
+        for (n = 0; n < BLOCK; n++){
+            x0 = ref[n];
+            y0 = (c->b0 * x0 + c->b1 * x1 + c->b2 * x2 - c->a1 * y1 - c->a2 * y2) / 16384;
+            ref[n] = y0;
+            x2 = x1;
+            x1 = x0;
+            y2 = y1;
+            y1 = y0;
+
+            e0 = exact[n];
+            sum = ((int64_t) c->b0 * e0 + (int64_t) c->b1 * e1 + (int64_t) c->b2 * e2 - (int64_t) c->a1 * f1 - (int64_t) c->a2 * f2) >> 14;
+            exact[n] = (sum > 32767) ? 32767 : (sum < -32768) ? -32768 : (int16_t) sum;
+            e2 = e1;
+            e1 = e0;
+            f2 = f1;
+            f1 = exact[n];
+        }
+    }
+
+    DSP_IIRInit(&f, iirCoeff, iirState, IIR_SECTIONS);
+    DSP_IIRBlock(&f, in, out, BLOCK / 2);                                       // two blocks so the state carries over
+    DSP_IIRBlock(&f, in + BLOCK / 2, out + BLOCK / 2, BLOCK / 2);
+    for (n = 0; n < BLOCK; n++){
+        if (out[n] != exact[n]){
+            bad++;
+        }
+        diff = fabs(ref[n] - out[n]);
+        worst = (diff > worst) ? diff : worst;
+    }
+    bound = IIRTruncBound(iirCoeff, IIR_SECTIONS);
+    *hash = Hash(2166136261UL, out, BLOCK);
+    printf("IIR                        %u mismatches, worst %.2f LSB from double, bound %.2f\n", bad, worst, bound);
+    return (bad != 0) || (worst >= bound);
+}
+
+
+static int CheckGolden(const char *name, uint32_t hash, uint32_t golden){
+    printf("%-10s checksum      0x%08lX %s\n", name, (unsigned long) hash, (hash == golden) ? "ok" : "CHANGED");
+    return hash != golden;
+}
+
+
+int main(void){
+    uint32_t fft, goertzel, fir, iir;
+    int fail = 0;
+
+    fail |= CheckSac();
+    fail |= CheckFFT(&fft);
+    fail |= CheckGoertzel(&goertzel);
+    fail |= CheckFIR(&fir);
+    fail |= CheckIIR(&iir);
+    fail |= CheckGolden("FFT", fft, GOLDEN_FFT);
+    fail |= CheckGolden("Goertzel", goertzel, GOLDEN_GOERTZEL);
+    fail |= CheckGolden("FIR", fir, GOLDEN_FIR);
+    fail |= CheckGolden("IIR", iir, GOLDEN_IIR);
+    printf("%s\n", fail ? "FAIL" : "PASS");
+    return fail;
+}
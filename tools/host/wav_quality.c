@@ -0,0 +1,198 @@
+/* ************************************************************************** */
+// Nanolay - Sine Output Quality Report
+//
+// Description:     Replays the sine sample ISR math of nanolay_wavgen.c on the
+//                  host (32bit DDS phase, quarter wave table lookup with or
+//                  without interpolation, Q15 amplitude scaling, integer DAC
+//                  codes) and reports THD and SFDR per output frequency. The
+//                  table is built like tools/gen_wavtables.py does, so smaller
+//                  tables or fewer bits can be judged before regenerating.
+//
+// Target Device:   Host
+//
+// Usage:           make -C tools/host quality
+//                  tools/host/build/wav_quality [--size N] [--bits B]
+//                      [--amplitude A] [--rate Fs]
+//
+// Author:          Mark Angelo Tarvina (mttarvina)
+// Email:           mttarvina@gmail.com
+// Revision:        1.0
+// Last Updated:    17.Oct.2026
+/* ************************************************************************** */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <math.h>
+#include "nanolay_dds.h"
+
+
+#define FFT_POINTS      16384
+#define DAC_BITS        12
+#define FULL_SCALE      0x7FFF                                                  // WAV_FULL_SCALE
+#define LOBE_BINS       4                                                       // main lobe half width of the window
+#define HARMONICS       9                                                       // 2nd to 10th
+
+
+static const uint32_t freqs[] = {100, 1000, 2000, 5000, 10000, 20000, 30000, 40000};
+static double re[FFT_POINTS];
+static double im[FFT_POINTS];
+static double power[FFT_POINTS / 2 + 1];
+
+
+// Same table as tools/gen_wavtables.py, Python rounds halves to even
+static int16_t *QuarterTable(unsigned size, unsigned peak, unsigned step){
+    int16_t *t = malloc((size + 1) * sizeof(int16_t));
+    unsigned i;
+
+    for (i = 0; i <= size; i++){
+        t[i] = (int16_t) (nearbyint(peak * sin(M_PI / 2 * i / size) / step) * step);
+    }
+    return t;
+}
+
+
+static inline int16_t Scale(int16_t sample, int16_t amplitude){
+    return (int16_t) ((sample * amplitude + 0x4000) >> 15);                     // WAV_Scale()
+}
+
+
+static void FFT(void){
+    unsigned i, j, bit, len, k;
+    double wr, wi, ur, ui, vr, vi, t, a;
+
+    for (i = 1, j = 0; i < FFT_POINTS; i++){
+        for (bit = FFT_POINTS >> 1; j & bit; bit >>= 1){
+            j ^= bit;
+        }
+        j |= bit;
+        if (i < j){
+            t = re[i]; re[i] = re[j]; re[j] = t;
+            t = im[i]; im[i] = im[j]; im[j] = t;
+        }
+    }
+    for (len = 2; len <= FFT_POINTS; len <<= 1){
+        for (k = 0; k < len / 2; k++){
+            a = -2 * M_PI * k / len;
+            wr = cos(a);
+            wi = sin(a);
+            for (i = k; i < FFT_POINTS; i += len){
+                j = i + len / 2;
+                vr = re[j] * wr - im[j] * wi;
+                vi = re[j] * wi + im[j] * wr;
+                ur = re[i];
+                ui = im[i];
+                re[i] = ur + vr;
+                im[i] = ui + vi;
+                re[j] = ur - vr;
+                im[j] = ui - vi;
+            }
+        }
+    }
+}
+
+
+// Power summed over the main lobe around bin, clipped to the spectrum
+static double LobePower(long bin){
+    double sum = 0;
+    long k;
+
+    for (k = bin - LOBE_BINS; k <= bin + LOBE_BINS; k++){
+        if ((k >= 0) && (k <= FFT_POINTS / 2)){
+            sum += power[k];
+        }
+    }
+    return sum;
+}
+
+
+// Frequency of a harmonic after aliasing, as a bin
+static long FoldBin(double bin){
+    bin = fmod(bin, FFT_POINTS);
+    if (bin > FFT_POINTS / 2){
+        bin = FFT_POINTS - bin;
+    }
+    return lround(bin);
+}
+
+
+static void Measure(const int16_t *table, unsigned qSize, uint32_t rate, uint32_t freq, int interp, double *thd, double *sfdr){
+    uint32_t word = DDS_TuningWord(freq * DDS_MILLIHZ_PER_HZ, rate);
+    uint32_t phase = 0;
+    double w, fund, harm = 0, spur = 0, bin;
+    long peak, k;
+    unsigned n;
+    int h;
+
+    for (n = 0; n < FFT_POINTS; n++){                                           // 4 term Blackman-Harris, -92dB sidelobes
+        w = 0.35875 - 0.48829 * cos(2 * M_PI * n / FFT_POINTS) + 0.14128 * cos(4 * M_PI * n / FFT_POINTS) - 0.01168 * cos(6 * M_PI * n / FFT_POINTS);
+        re[n] = w * Scale(interp ? DDS_QuarterWaveInterp(phase, table, qSize) : DDS_QuarterWave(phase, table, qSize), FULL_SCALE);
+        im[n] = 0;
+        phase += word;
+    }
+    FFT();
+    for (n = 0; n <= FFT_POINTS / 2; n++){
+        power[n] = re[n] * re[n] + im[n] * im[n];
+    }
+
+    bin = (double) word * FFT_POINTS / 4294967296.0;
+    peak = lround(bin);
+    fund = LobePower(peak);
+    for (h = 2; h <= HARMONICS + 1; h++){
+        k = FoldBin(bin * h);
+        if (labs(k - peak) > 2 * LOBE_BINS){
+            harm += LobePower(k);
+        }
+    }
+    for (k = LOBE_BINS + 1; k <= FFT_POINTS / 2; k++){                          // DC lobe skipped
+        if ((labs(k - peak) > LOBE_BINS) && (power[k] > spur)){
+            spur = power[k];
+        }
+    }
+    *thd = 10 * log10((harm + 1e-30) / fund);
+    *sfdr = 10 * log10(power[peak] / (spur + 1e-30));
+}
+
+
+int main(int argc, char **argv){
+    unsigned size = 1600, bits = DAC_BITS, amplitude = 1842;                    // SAMPLE_SIZE, WAV_TABLE_BITS, SINE_AMPLITUDE
+    uint32_t rate = 100000;
+    double thd, sfdr, thdI, sfdrI;
+    int16_t *table;
+    unsigned i;
+    int a;
+
+    for (a = 1; a + 1 < argc; a += 2){
+        if (!strcmp(argv[a], "--size")){
+            size = (unsigned) atoi(argv[a + 1]);
+        }
+        else if (!strcmp(argv[a], "--bits")){
+            bits = (unsigned) atoi(argv[a + 1]);
+        }
+        else if (!strcmp(argv[a], "--amplitude")){
+            amplitude = (unsigned) atoi(argv[a + 1]);
+        }
+        else if (!strcmp(argv[a], "--rate")){
+            rate = (uint32_t) atol(argv[a + 1]);
+        }
+    }
+    if ((size < 4) || (size % 4) || (bits < 1) || (bits > DAC_BITS) || (rate == 0)){
+        fprintf(stderr, "size must be a multiple of 4, bits 1 to %d, rate above 0\n", DAC_BITS);
+        return 1;
+    }
+
+    table = QuarterTable(size / 4, amplitude, 1u << (DAC_BITS - bits));
+    printf("SAMPLE_SIZE %u, %u bits, peak %u LSB, Fs %lu Hz, %d point FFT\n", size, bits, amplitude, (unsigned long) rate, FFT_POINTS);
+    printf("%10s  %10s %10s  %10s %10s\n", "freq Hz", "THD dB", "SFDR dB", "THD interp", "SFDR interp");
+    for (i = 0; i < sizeof(freqs) / sizeof(freqs[0]); i++){
+        if (freqs[i] >= rate / 2){
+            break;
+        }
+        Measure(table, size / 4, rate, freqs[i], 0, &thd, &sfdr);
+        Measure(table, size / 4, rate, freqs[i], 1, &thdI, &sfdrI);
+        printf("%10lu  %10.1f %10.1f  %10.1f %10.1f\n", (unsigned long) freqs[i], thd, sfdr, thdI, sfdrI);
+    }
+    free(table);
+    return 0;
+}
@@ -0,0 +1,177 @@
+#!/usr/bin/env python3
+# *****************************************************************************
+# Nanolay - Clip Converter
+#
+# Description:     Converts a mono WAV file into a C source file holding a
+#                  WAV_Clip for the clip player in nanolay_wavgen.c. The
+#                  audio is stored as IMA-ADPCM blocks (WAV format 0x0011
+#                  layout, 4 bits per sample) or as unsigned 8bit PCM. The
+#                  data array is placed in program memory (auto_psv). All
+#                  auto_psv data of a program shares one 32KB PSV page: the
+#                  library sine tables, every clip and any other const data
+#                  of the application. The clip is checked against what is
+#                  left of that page; pass the other clips linked into the
+#                  same program with --with and other const data with
+#                  --psv-used.
+#
+# Usage:           python3 tools/wav2clip.py input.wav name [-o name.c]
+#                      [--format adpcm|pcm8] [--block-align 256]
+#                      [--with other.c ...] [--psv-used BYTES]
+#
+#                  then in the application:
+#                      extern const WAV_Clip name;
+#                      WAV_Clip_Init(false, false, &name, false);
+# *****************************************************************************
+
+import argparse
+import os
+import re
+import struct
+import sys
+import wave
+
+PSV_PAGE_SIZE = 32768
+HEADER_SIZE = 4
+WAVGEN_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'nanolay_lib', 'nanolay_wavgen.h')
+
+INDEX_TABLE = [-1, -1, -1, -1, 2, 4, 6, 8] * 2
+
+STEP_TABLE = [
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+    19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+    50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+    130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+    337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+    2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+    5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+]
+
+
+def read_wav(path):
+    with wave.open(path, 'rb') as w:
+        channels, width, rate, count = w.getnchannels(), w.getsampwidth(), w.getframerate(), w.getnframes()
+        raw = w.readframes(count)
+    if width == 1:
+        frames = [(b - 128) << 8 for b in raw]
+    elif width == 2:
+        frames = list(struct.unpack('<%dh' % (len(raw) // 2), raw))
+    else:
+        raise SystemExit('only 8 and 16bit WAV files are supported')
+    if channels > 1:                                                            # mix down to mono
+        frames = [sum(frames[i:i + channels]) // channels for i in range(0, len(frames), channels)]
+    return frames, rate
+
+
+def decode(state, nibble):
+    # same arithmetic as ADPCM_Decode(), so encoder and player never drift
+    predictor, index = state
+    step = STEP_TABLE[index]
+    diff = step >> 3
+    if nibble & 4:
+        diff += step
+    if nibble & 2:
+        diff += step >> 1
+    if nibble & 1:
+        diff += step >> 2
+    predictor = predictor - diff if nibble & 8 else predictor + diff
+    predictor = max(-32768, min(32767, predictor))
+    index = max(0, min(len(STEP_TABLE) - 1, index + INDEX_TABLE[nibble]))
+    return predictor, index
+
+
+def encode_nibble(state, sample):
+    # try all 16 codes and keep the one that decodes closest, cheap at build time
+    best = min(range(16), key=lambda n: abs(decode(state, n)[0] - sample))
+    return best, decode(state, best)
+
+
+def encode_adpcm(frames, block_align):
+    per_block = 1 + 2 * (block_align - HEADER_SIZE)
+    data = bytearray()
+    index = 0
+    for start in range(0, len(frames), per_block):
+        block = frames[start:start + per_block]
+        state = (block[0], index)
+        data += struct.pack('<hBB', block[0], index, 0)
+        nibbles = []
+        for sample in block[1:]:
+            nibble, state = encode_nibble(state, sample)
+            nibbles.append(nibble)
+        if len(nibbles) % 2:
+            nibbles.append(0)                                                   # padding, never played, the clip stores its sample count
+        data += bytes(nibbles[i] | (nibbles[i + 1] << 4) for i in range(0, len(nibbles), 2))
+        index = state[1]
+    return data
+
+
+def library_psv_size():
+    # sineQTable and sineQ15QTable, SINE_QTABLE_SIZE + 1 words each
+    with open(WAVGEN_HEADER) as f:
+        match = re.search(r'#define\s+SAMPLE_SIZE\s+(\d+)', f.read())
+    if not match:
+        raise SystemExit('SAMPLE_SIZE not found in %s' % WAVGEN_HEADER)
+    return 2 * 2 * (int(match.group(1)) // 4 + 1)
+
+
+def clip_psv_size(path):
+    # data array size of a source file written by this tool
+    with open(path) as f:
+        match = re.search(r'space\(auto_psv\)+\s+\w+\[(\d+)\]', f.read())
+    if not match:
+        raise SystemExit('%s is not a clip written by wav2clip.py' % path)
+    return int(match.group(1))
+
+
+def format_bytes(data):
+    rows = [','.join('0x%02x' % b for b in data[i:i + 16]) for i in range(0, len(data), 16)]
+    return ',\n    '.join(rows)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Convert a WAV file into a WAV_Clip C source file')
+    ap.add_argument('input', help='mono or stereo, 8 or 16bit WAV file')
+    ap.add_argument('name', help='C identifier of the clip')
+    ap.add_argument('-o', '--output', help='output file, default <name>.c')
+    ap.add_argument('--format', choices=['adpcm', 'pcm8'], default='adpcm')
+    ap.add_argument('--block-align', type=int, default=256, help='ADPCM bytes per block, including the 4 byte header')
+    ap.add_argument('--with', dest='others', action='append', default=[], metavar='FILE', help='another clip source linked into the same program')
+    ap.add_argument('--psv-used', type=int, default=0, metavar='BYTES', help='other auto_psv data of the application, in bytes')
+    args = ap.parse_args()
+
+    if args.block_align <= HEADER_SIZE:
+        raise SystemExit('block-align must be above %d' % HEADER_SIZE)
+    frames, rate = read_wav(args.input)
+    if not frames:
+        raise SystemExit('%s has no samples' % args.input)
+
+    if args.format == 'adpcm':
+        data = encode_adpcm(frames, args.block_align)
+        fmt = 'WAV_CLIP_IMA_ADPCM'
+    else:
+        data = bytes(max(0, min(255, ((s + 128) >> 8) + 128)) for s in frames)
+        fmt = 'WAV_CLIP_PCM8'
+    used = library_psv_size() + args.psv_used + sum(clip_psv_size(other) for other in args.others)
+    if used + len(data) > PSV_PAGE_SIZE:
+        raise SystemExit('%d bytes do not fit, %d of the %d byte PSV page are used by the sine tables and the other data, '
+                         'shorten or resample the clip' % (len(data), used, PSV_PAGE_SIZE))
+
+    out = args.output or (args.name + '.c')
+    with open(out, 'w') as f:
+        f.write('// Generated by tools/wav2clip.py from %s, do not edit\n' % os.path.basename(args.input))
+        f.write('// %d samples at %dHz, %d bytes\n\n' % (len(frames), rate, len(data)))
+        f.write('#include "nanolay_lib/nanolay.h"\n#include "nanolay_lib/nanolay_wavgen.h"\n\n\n')
+        f.write('static const uint8_t __attribute__((space(auto_psv))) %s_data[%d] = {\n    %s\n};\n\n\n' % (args.name, len(data), format_bytes(data)))
+        f.write('const WAV_Clip %s = {\n' % args.name)
+        f.write('    .data = %s_data,\n' % args.name)
+        f.write('    .samples = %dUL,\n' % len(frames))
+        f.write('    .blockAlign = %d,\n' % (args.block_align if args.format == 'adpcm' else 0))
+        f.write('    .format = %s,\n' % fmt)
+        f.write('    .samplingFrequency = %dUL\n' % rate)
+        f.write('};\n')
+    sys.stderr.write('wrote %s: %d samples, %d bytes, %d of %d PSV bytes used\n' % (out, len(frames), len(data), used + len(data), PSV_PAGE_SIZE))
+
+
+if __name__ == '__main__':
+    main()